@@ -75,6 +75,17 @@ public:
   bool overflow () const { return x->overflow (); }
   suiolite *uio () const { return in; }
 
+  // point at a different connection (or none), so that a recycled
+  // parser can keep its abuf_t.
+  void rebind (ptr<ahttpcon> xx)
+  {
+    if (x) finish ();
+    x = xx;
+    in = x ? x->uio () : NULL;
+    eof = x ? x->ateof () : false;
+    cb = NULL;
+  }
+
 private:
   ptr<ahttpcon> x;
   suiolite *in;
@@ -129,6 +140,7 @@ public:
   str mirror_debug ();
   bool overflow () const { return src->overflow (); }
   size_t flush (char *c, size_t l); // flushes buffered data to buffer.
+  abuf_stat_t skip (size_t *n);     // consume *n bytes without copying
   ssize_t dump (char *buf, size_t len);
 
   // stream the data in the buffer out in arbitrary-sized blocks
@@ -140,6 +152,20 @@ public:
     mirror_p = NULL;
   }
 
+  // back to the just-constructed state, keeping the source.
+  void reinit ()
+  {
+    bc = false;
+    lch = 0;
+    _basep = _endp = _cp = NULL;
+    len = 0;
+    erc = ABUF_OK;
+    spcs = 0;
+    lim = -1;
+    ccnt = 0;
+    mirror_base = mirror_p = mirror_end = NULL;
+  }
+
   int get_ccnt() const { return ccnt - (bc ? 1 : 0); }
 
 private:
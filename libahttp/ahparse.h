@@ -59,6 +59,11 @@ public:
   void parse (cbi cb);
   size_t inreq_header_len () const { return _header_sz; }
 
+  // Reset for another request on connection x (or none, if x is NULL),
+  // keeping buffers and tables.  A parser built over a caller-supplied
+  // abuf_t only resets its state; rebinding the abuf is up to the caller.
+  virtual void reinit (ptr<ahttpcon> x);
+
 protected:
   virtual void v_parse_cb1 (int status) { finish (status); }
   virtual void v_cancel () {}
@@ -71,6 +76,7 @@ protected:
 private:
   ptr<ahttpcon> _parser_x;
 protected:
+  abuf_con_t *_abuf_con;  // non-NULL if we made _abuf ourselves
   abuf_t *_abuf;
   bool _del_abuf;
   u_int timeout;
@@ -91,6 +97,7 @@ public:
   virtual http_inhdr_t *hdr_p () override { return &hdr; }
   virtual const http_inhdr_t &hdr_cr () const override { return hdr; }
   void v_cancel () override { hdr.cancel (); }
+  void reinit (ptr<ahttpcon> x) override;
 
   static ptr<http_parser_raw_t> alloc (ptr<ahttpcon> xx, u_int t = 0)
   { return New refcounted<http_parser_raw_t> (xx, t); }
@@ -111,6 +118,7 @@ public:
   virtual http_inhdr_t * hdr_p () override { return &hdr; }
   const http_inhdr_t &hdr_cr () const override { return hdr; }
   void finish2 (int s1, int s2);
+  void reinit (ptr<ahttpcon> x) override;
 
   cgi_t & get_cookie () { return *hdr.get_cookie (); }
   const cgi_t & get_cookie () const { return *hdr.get_cookie (); }
@@ -121,6 +129,11 @@ public:
   virtual bool want_raw_body() { return false; }
   const str get_raw_body() { return m_raw_body; }
 
+  // Like want_raw_body(), but the body is also parsed as JSON, while it
+  // arrives; get_json_body() is NULL if it wasn't JSON.
+  virtual bool want_json_body() { return false; }
+  ptr<pub3::expr_t> get_json_body() { return m_json_body; }
+
 protected:
   // called to prepare a parsing of a post body.
   cbi::ptr prepare_post_parse (int status);
@@ -131,6 +144,7 @@ public:
 
 private:
   str m_raw_body;
+  ptr<pub3::expr_t> m_json_body;
 
 };
 
@@ -142,6 +156,7 @@ public:
   void v_cancel () override { hdr.cancel (); post.cancel (); }
   virtual void v_parse_cb1 (int status) override;
   void enable_file_upload () { mpfd_flag = true; }
+  void reinit (ptr<ahttpcon> x) override;
 
   static ptr<http_parser_cgi_t> alloc (ptr<ahttpcon> xx, u_int t = 0)
   { return New refcounted<http_parser_cgi_t> (xx, t); }
@@ -104,6 +104,44 @@ struct keepalive_data_t {
 
 //=======================================================================
 
+//
+// ahttp_hdr_index_t
+//
+//   Offsets into a request's raw bytes for the request line and each
+//   header key/value.  okd computes one while it's looking at the
+//   request anyway, and ships it to the service along with the bytes,
+//   so that the service can fill in its http_inhdr_t without scanning
+//   the whole header a second time.
+//
+struct ahttp_hdr_index_t {
+  struct span_t {
+    span_t () : _off (0), _len (0) {}
+    span_t (u_int32_t o, u_int32_t l) : _off (o), _len (l) {}
+    u_int32_t _off, _len;
+  };
+  struct field_t {
+    span_t _key, _val;
+  };
+
+  ahttp_hdr_index_t () : _has_query (false), _hdr_len (0) {}
+
+  // Fill in from buf[0,len); returns false if the header isn't all
+  // there, or has anything our simple scanner doesn't handle.  Doesn't
+  // copy buf; set _buf before calling get ().
+  bool build (const char *buf, size_t len);
+
+  str get (const span_t &s) const { return str (_buf.cstr () + s._off, s._len); }
+  bool check () const;
+
+  str _buf;         // the header bytes the spans point into
+  span_t _mthd, _target, _query, _vers, _line1;
+  bool _has_query;
+  size_t _hdr_len;  // header length, including the final blank line
+  vec<field_t> _fields;
+};
+
+//=======================================================================
+
 class ahttpcon : public ok_xprt_base_t
 {
 protected:
@@ -155,9 +193,16 @@ public:
   void spacecb ();
   void error (int ec);
   void send (const strbuf &b, cbv::ptr drained, cbv::ptr sent = NULL);
+
+  // Like send, but whatever doesn't go out on the first writev is
+  // queued by reference into b's memory instead of being copied; b
+  // is held until it has drained.  The caller must not consume b.
+  void send_ref (const strbuf &b, cbv::ptr drained, cbv::ptr sent = NULL);
   void sendv (const iovec *iov, int cnt, cbv::ptr drained = NULL,
 	      cbv::ptr sent = NULL);
   void send2 (const strbuf &b, event<ssize_t>::ref ev, CLOSURE);
+  void sendfile2 (int ffd, off_t off, size_t len, event<ssize_t>::ref ev, 
+		  CLOSURE);
   void copyv (const iovec *iov, int cnt);
   suiolite *uio () const { return in; }
   size_t get_bytes_sent () const { return bytes_sent; }
@@ -166,6 +211,11 @@ public:
   size_t set_keepalive_data (const keepalive_data_t &d);
   u_int get_reqno () const { return _reqno; }
 
+  // A header index from okd is good for the first request only.
+  void set_hdr_index (ptr<ahttp_hdr_index_t> i) { _hdr_index = i; }
+  ptr<ahttp_hdr_index_t> take_hdr_index () 
+  { ptr<ahttp_hdr_index_t> r = _hdr_index; _hdr_index = NULL; return r; }
+
   str select_set () const;
   str all_info () const;
   virtual str get_debug_info () const { return NULL; }
@@ -185,11 +235,25 @@ public:
 			      int mb = -1, int rcvlimit = -1, 
 			      bool coe = true, bool ma = true)
   { return New refcounted<ahttpcon> (fd, s, mb, rcvlimit, coe, ma); }
+
+  // Like alloc (fd, s, -1, -1, coe, ma), but reuse a retired ahttpcon,
+  // and its buffers, if there is one.  Connections made here go back
+  // to the pool when released, up to ClientRecycleLimit of them.
+  static ptr<ahttpcon> alloc_recycled (int fd, sockaddr_in *s, 
+				       bool coe, bool ma);
+  static const recycle_t<ahttpcon> &recycler ();
+  void finalize ();
+
   bool closed () const { return fd < 0; }
   bool overflow () const { return overflow_flag; }
   int set_lowwat (int sz);
   bool timed_out () const { return _timed_out; }
   void set_drained_cb (cbv::ptr cb);
+
+  // Call cb once at most lowat bytes are queued for the client (right
+  // away if that's already so, or if the connection is gone).
+  void set_lowat_cb (size_t lowat, cbv::ptr cb);
+  size_t out_resid () const { return out->resid (); }
   void cancel () { fail(); }
   void stop_read ();
   void short_circuit_output ();
@@ -198,7 +262,7 @@ public:
   template<size_t n> void
   collect_scraps (rpc_bytes<n> &out) { in->load_into_xdr<n> (out); }
   
-  const time_t start;
+  time_t start;
 
 protected:
   void set_remote_ip ();
@@ -213,12 +277,19 @@ protected:
   bool enable_selread ();
   void disable_selread ();
   void call_drained_cb ();
+  void call_lowat_cb ();
   void zombie_warn (ptr<bool> df);
+  void release_fd ();
+  void retire ();
+  void init (int f, sockaddr_in *s, int rcvlmt, bool coe, bool ma);
+  void reinit (int f, sockaddr_in *s, bool coe, bool ma);
 
   int fd;
   cbi::ptr rcb;
   cbv::ptr eofcb;
   cbv::ptr drained_cb;
+  cbv::ptr _lowat_cb;
+  size_t _lowat;
   bool rcbset, wcbset;
   suiolite *in;
   int _bytes_recv, bytes_sent;
@@ -230,7 +301,7 @@ protected:
   bool overflow_flag;
   syscall_stats_t *ss;
   struct sockaddr_in sin3;
-  const bool sin_alloced;
+  bool sin_alloced;
 
   ptr<cbv_countdown_t> cbcd;
   bool _timed_out;
@@ -238,6 +309,7 @@ protected:
   bool _delayed_close;
   timecb_t *_zombie_tcb;
   state_t _state;
+  ptr<ahttp_hdr_index_t> _hdr_index;
 
 public:
   rpc_bytes<> request_bytes;
@@ -252,6 +324,7 @@ private:
 
 protected:
   u_int _reqno; // for Keep-Alive, this is incremented once-per
+  bool _recyclable;
 };
 
 // for parent dispatcher, which will send fd's
@@ -315,6 +388,7 @@ private:
   void end_read ();
   ptr<ahttp_delimit_res> delimit (int *delimit_status);
   ptr<ahttp_delimit_res> delimit_headers (int *delimit_status);
+  ptr<ahttp_delimit_res> delimit_from_index (int *delimit_status);
   
   template<class B>
   str parse_reqline(const B& bytes, size_t size, int* delimit_status) {
@@ -26,6 +26,7 @@
 #define _LIBAHTTP_APARSE_H
 
 #include "abuf.h"
+#include "pub3json.h"
 
 //
 // Asynchronous Parser Skeleton Class
@@ -76,6 +77,9 @@ public:
         m_ok(false)
     {}
 
+    // Feed the body to p as it comes in.
+    void set_json_parser(ptr<pub3::json_fast_parser_t> p) { m_json = p; }
+
     str contents() {
         if (!m_ok) {
             return str(NULL);
@@ -96,6 +100,9 @@ protected:
                 assert(rc == ABUF_EOFCHAR || rc == ABUF_WAITCHAR);
                 break;
             }
+            if (m_json) {
+                m_json->add(m_bp, rc);
+            }
             m_bp += rc;
         }
         if (m_bp == m_endp || rc == ABUF_EOFCHAR) {
@@ -108,6 +115,7 @@ protected:
     mstr m_body;
     char *m_bp, *m_endp;
     bool m_ok;
+    ptr<pub3::json_fast_parser_t> m_json;
 };
 
 class async_dumper_t : public async_parser_t {
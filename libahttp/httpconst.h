@@ -48,6 +48,7 @@
 #define HTTP_REQ_TOO_BIG         413
 #define HTTP_URI_TOO_BIG         414
 #define HTTP_UNSUPPORTED_MEDIA   415
+#define HTTP_RANGE_NOT_SATISFIABLE 416
 #define HTTP_UNEXPECTED_EOF      417
 
 #define HTTP_SRV_ERROR           500
@@ -28,6 +28,7 @@
 #include "hdr.h"
 #include "okcgi.h"
 #include "qhash.h"
+#include "ahttp.h"
 
 typedef enum { INHDRST_START = 0,
 	       INHDRST_SPC1 = 1,
@@ -40,7 +41,8 @@ typedef enum { INHDRST_START = 0,
 	       INHDRST_SPC3 = 8,
 	       INHDRST_VALUE = 9,
 	       INHDRST_EOL2A = 10,
-	       INHDRST_EOL2B = 11 } inhdrst_t;
+	       INHDRST_EOL2B = 11,
+	       INHDRST_INDEXED = 12 } inhdrst_t;
 
 typedef enum { HTTP_MTHD_NONE = 0,
 	       HTTP_MTHD_POST = 1,
@@ -90,7 +92,8 @@ public:
       _conn_mode (HTTP_CONN_NONE),
       _reqno (0),
       _pipeline_eof_ok (false),
-      _parse_query_string (ok_http_parse_query_string) {}
+      _parse_query_string (ok_http_parse_query_string),
+      _index_skip (0) {}
 
   inline str get_line1 () const { return line1; }
   inline str get_target () const { return target; }
@@ -102,6 +105,8 @@ public:
   inline u_int get_reqno () const { return _reqno; }
   str get_connection () const;
   void set_parse_query_string (bool b) { _parse_query_string = b; }
+  void set_hdr_index (ptr<ahttp_hdr_index_t> i) { _hdr_index = i; }
+  void reinit ();  // forget the last request, keeping tables and scratch
 
   str get_user_agent (bool null_ok = true) const;
   str get_referrer (bool null_ok = false) const;
@@ -124,6 +129,7 @@ protected:
   virtual void ext_parse_cb (int dummy);
   virtual void fixup ();
   ptr<ok::scratch_handle_t> alloc_scratch2 ();
+  abuf_stat_t parse_from_index ();
 
   ptr<cgi_t> _cookie;
   ptr<cgi_t> _url;
@@ -140,6 +146,9 @@ protected:
   u_int _reqno;     // serial # of this request within an HTTP/1.1 pipeline
   bool _pipeline_eof_ok;
   bool _parse_query_string;
+
+  ptr<ahttp_hdr_index_t> _hdr_index; // pre-parsed by okd, if available
+  size_t _index_skip;                // header bytes left to step over
 };
 
 
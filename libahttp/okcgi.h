@@ -92,8 +92,10 @@ public:
   virtual str encode () const;
   
   static ptr<cgi_t> str_parse (const str &s);
+  void parse_str (const str &s);
 
   void reset_state ();
+  void reinit ();    // drop all pairs and parse state, for reuse
   void set_uri_mode (bool b) { uri_mode = b; }
   // next function is virtual for MW, who wants to hook in at this point
   // in the parsing.
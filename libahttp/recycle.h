@@ -21,19 +21,97 @@
  *
  */
 
+#ifndef _LIBAHTTP_RECYCLE_H
+#define _LIBAHTTP_RECYCLE_H 1
+
 #include "async.h"
 
 /*
  * recyle.h
  *
- *    incomplete attempt to make a recycling class for commonly-allocated
- *    objects 
+ *    recycling for commonly-allocated objects and I/O buffers.
  *
  */
 
+//-----------------------------------------------------------------------
+
+//
+// recycle_t -- a bounded free list of C's, that counts how often
+//   it could and could not satisfy a request.  The caller owns what it
+//   get ()s, and must dispose of what it can't put () back.
+//
 template<class C>
 class recycle_t {
 public:
-  
+  recycle_t (size_t l = 0) : _lim (l), _hits (0), _misses (0) {}
+
+  C *get ()
+  {
+    if (_free.size ()) { _hits++; return _free.pop_back (); }
+    _misses++;
+    return NULL;
+  }
+
+  bool put (C *c)
+  {
+    if (_free.size () >= _lim) return false;
+    _free.push_back (c);
+    return true;
+  }
+
+  // pull one off the free list for disposal, without counting it.
+  C *trim () { return _free.size () ? _free.pop_back () : NULL; }
+
+  void set_limit (size_t l) { _lim = l; }
+  size_t size () const { return _free.size (); }
+  u_int64_t hits () const { return _hits; }
+  u_int64_t misses () const { return _misses; }
+
+private:
+  vec<C *> _free;
+  size_t _lim;
+  u_int64_t _hits, _misses;
+};
+
+//-----------------------------------------------------------------------
 
+struct buf_pool_stats_t {
+  buf_pool_stats_t () 
+    : _hits (0), _misses (0), _n_retained (0), _bytes_retained (0) {}
+  u_int64_t _hits;
+  u_int64_t _misses;
+  u_int64_t _n_retained;
+  u_int64_t _bytes_retained;
 };
+
+//
+// buf_pool_t -- process-wide pool for the char buffers under suiolites.
+//   Buffers are binned by size, rounded up to BUF_POOL_GRAIN; a freed
+//   buffer is kept for reuse so long as the total held across all bins
+//   stays under ok_buf_pool_max_bytes (0 disables the pool).  Buffers
+//   bigger than BUF_POOL_MAX_BUFLEN go straight to malloc.
+//
+#define BUF_POOL_GRAIN       0x400
+#define BUF_POOL_MAX_BUFLEN  0x40000   // == SUIOLITE_MAX_BUFLEN
+
+class buf_pool_t {
+public:
+  buf_pool_t () : _bytes_retained (0) {}
+  char *alloc (size_t len);
+  void release (char *b, size_t len);
+  void get_stats (buf_pool_stats_t *s) const;
+
+private:
+  enum { N_CLASSES = BUF_POOL_MAX_BUFLEN / BUF_POOL_GRAIN + 1 };
+  static size_t size_class (size_t len) 
+  { return (len + BUF_POOL_GRAIN - 1) / BUF_POOL_GRAIN; }
+  static size_t class_size (size_t c) { return c * BUF_POOL_GRAIN; }
+  void trim (size_t want);
+
+  recycle_t<char> _classes[N_CLASSES];
+  size_t _bytes_retained;
+};
+
+extern buf_pool_t global_buf_pool;
+
+#endif /* _LIBAHTTP_RECYCLE_H */
@@ -199,6 +199,10 @@ public:
   { return attributes.get_method () == HTTP_MTHD_HEAD; }
   void disable_gzip ();
 
+  // empty the fields, keeping their storage, and take new attributes
+  void reinit (const http_resp_attributes_t &a)
+  { attributes = a; fields.setsize (0); cleanme = false; }
+
 protected:
   http_resp_attributes_t attributes;
   vec<http_hdr_field_t> fields;
@@ -299,17 +303,35 @@ protected:
 
 //-----------------------------------------------------------------------
 
-class http_response_ok_t : public http_response_t {
+class http_response_ok_t : public http_response_t, 
+			   public virtual refcount {
 public:
   http_response_ok_t (const strbuf &b, const http_resp_attributes_t &a) :
-    http_response_t (http_resp_header_ok_t (b.tosuio ()->resid (), a), b) 
-  {}
+    http_response_t (http_resp_header_ok_t (b.tosuio ()->resid (), a), b),
+    _recyclable (false) {}
 
 //-----------------------------------------------------------------------
   
   // for piece-meal output mode
   http_response_ok_t (size_t s, const http_resp_attributes_t &a) :
-    http_response_t (http_resp_header_ok_t (s, a)) {}
+    http_response_t (http_resp_header_ok_t (s, a)), _recyclable (false) {}
+
+//-----------------------------------------------------------------------
+
+  // As the constructors, but reuse a response (and its header field
+  // vec) that an earlier request let go of.  Responses made here go
+  // back to the pool when released, up to ClientRecycleLimit of them.
+  static ptr<http_response_ok_t> 
+  alloc (const strbuf &b, const http_resp_attributes_t &a);
+  static ptr<http_response_ok_t> 
+  alloc (size_t s, const http_resp_attributes_t &a);
+  static const recycle_t<http_response_ok_t> &recycler ();
+  void finalize ();
+
+private:
+  static http_response_ok_t *get_recycled (ssize_t s, 
+					   const http_resp_attributes_t &a);
+  bool _recyclable;
 };
 
 //-----------------------------------------------------------------------
@@ -0,0 +1,86 @@
+// -*-c++-*-
+/* $Id$ */
+
+/*
+ *
+ * Copyright (C) 2002-2004 Maxwell Krohn (max@okcupid.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+#ifndef __LIBAHTTP_RESPFILE__
+#define __LIBAHTTP_RESPFILE__
+
+#include "resp.h"
+#include "inhdr.h"
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------
+
+//
+// http_response_file_t -- serve a file from disk.  The header is built
+// in memory; the body goes from the page cache to the connection with
+// sendfile(2), so the file's bytes never enter user space.  Handles
+// ETag/Last-Modified validation (304), and a single byte range (206,
+// or 416 if unsatisfiable); multi-range requests get the whole file.
+//
+class http_response_file_t : public http_response_base_t, 
+			     public virtual refcount {
+public:
+  // Takes over fd, which must be open for reading on a regular file.
+  // req may be NULL, in which case no conditional or range handling
+  // is done.
+  http_response_file_t (const http_resp_attributes_t &a, int fd,
+			const struct stat &sb, const http_inhdr_t *req);
+  ~http_response_file_t ();
+
+  // Open path; NULL (with errno set) if it isn't a readable regular file.
+  static ptr<http_response_file_t> 
+  alloc (const http_resp_attributes_t &a, const str &path, 
+	 const http_inhdr_t *req);
+
+  http_resp_header_t *get_header () { return &_header; }
+  const http_resp_header_t *get_header () const { return &_header; }
+
+  u_int send (ptr<ahttpcon> x, cbv::ptr cb);
+  void send2 (ptr<ahttpcon> x, ev_ssize_t ev) { send2_T (x, ev); }
+  size_t get_nbytes () const { return _send_body ? _len : 0; }
+
+  static str make_etag (const struct stat &sb);
+  static bool parse_date (const str &s, time_t *out);
+
+protected:
+  void send2_T (ptr<ahttpcon> x, ev_ssize_t ev, CLOSURE);
+  void send_T (ptr<ahttpcon> x, cbv::ptr cb, CLOSURE);
+  void fill (const http_inhdr_t *req);
+  int parse_range (const str &r);
+
+  http_resp_header_t _header;
+  int _fd;
+  size_t _fsize;      // size of the whole file
+  off_t _off;         // start of the part we're sending
+  size_t _len;        // and its length
+  str _etag;
+  time_t _mtime;
+  str _last_mod;
+  bool _send_body;
+  strbuf _hdr_out;
+};
+
+//------------------------------------------------------------------------
+
+#endif /* __LIBAHTTP_RESPFILE__ */
@@ -33,6 +33,7 @@
 
 #include "async.h"
 #include "arpc.h"
+#include "recycle.h"
 
 struct syscall_stats_t {
   syscall_stats_t () : n_recvmsg (0), n_readvfd (0), n_readv (0),
@@ -100,13 +101,13 @@ public:
   enum { N_REGIONS = 2 } ;
 
   suiolite (int l = SUIOLITE_DEF_BUFLEN, cbv::ptr s = NULL) 
-    : len (min<int> (l, SUIOLITE_MAX_BUFLEN)), buf ((char *)xmalloc (len)),
+    : len (min<int> (l, SUIOLITE_MAX_BUFLEN)), buf (global_buf_pool.alloc (len)),
       bep (buf + len), rp (buf), scb (s), peek (false), bytes_read (0),
       dont_peek (false)
   {
     for (int i = 0; i < N_REGIONS; i++) dep[i] = buf;
   }
-  ~suiolite () { xfree (buf); }
+  ~suiolite () { global_buf_pool.release (buf, len); }
 
   void clear ();
   void recycle (cbv::ptr s = NULL) { setscb (s); }
@@ -30,6 +30,7 @@
 #include "ahttp.h"
 #include "okcgi.h"
 #include "resp.h"
+#include "respfile.h"
 #include "okprot.h"
 #include "inhdr.h"
 #include "pslave.h"
@@ -399,6 +400,20 @@ public:
   virtual oksrvc_t *get_oksrvc () { return oksrvc; }
   virtual const oksrvc_t *get_oksrvc () const { return oksrvc; }
 
+  // Object recycling (see ClientRecycleLimit).  A class that can serve
+  // more than one request returns true from recyclable (), and its
+  // reinit () resets all of its own per-request state after calling
+  // up to its parents'.  x is NULL while the object sits in the pool.
+  // okclnt_t (and so okclnt2_t) and okclnt3_t reset all of their own
+  // state, so a subclass that keeps nothing per-request need only
+  // return true here.  Only opt in if make_newclnt () always returns
+  // the same class.
+  virtual bool recyclable () const { return false; }
+  virtual void reinit (ptr<ahttpcon> x) {}
+
+  // Call instead of 'delete this' once the request is done.
+  void release ();
+
 protected:
   oksrvc_t *oksrvc;
 };
@@ -521,7 +536,7 @@ public:
 
   //-----------------------------------------------------------------------
 
-  virtual void send_complete () { delete this; }
+  virtual void send_complete () { release (); }
   virtual void serve_complete () {}
 
   //-----------------------------------------------------------------------
@@ -548,7 +563,8 @@ public:
   virtual void set_union_cgi_mode (bool b) override {}
 
   // stuff for piecemeal output
-  bool output_hdr (ssize_t sz = -1, cbv::ptr cb = nullptr);
+  bool output_hdr (ssize_t sz = -1, cbv::ptr cb = nullptr,
+		   compressible_t::opts_t cd = compressible_t::opts_t ());
   bool output_fragment (str s, cbv::ptr = nullptr);
   bool output_fragment (compressible_t &b, cbv::ptr done = NULL);
   void output_file (const char *fn, evb_t::ptr cb = NULL, 
@@ -557,6 +573,23 @@ public:
 
   void output_done (evb_t::ptr ev, CLOSURE);
 
+  // Publish a pub3 file as the whole response, sending its output to
+  // the client as it's produced (chunked, and gzipped if the client
+  // takes it) rather than all at once at the end.  Output goes out
+  // every ok_pub3_stream_hiwat bytes, and at flush() calls in the
+  // template; publishing pauses while more than that is still queued
+  // for the client.  Sends the headers itself, and finishes with
+  // output_done().
+  void output_file_stream (const char *fn, evb_t::ptr cb = NULL,
+			   ptr<pub3::dict_t> a = NULL,
+			   pub3::opts_t opt = 0, CLOSURE);
+
+  // Send a file from disk (path as seen from inside the jail) as the
+  // whole response, via sendfile; handles conditional GETs and byte
+  // ranges.  Replies 404 if the file can't be opened.  Set the 
+  // content type first.
+  void output_static_file (str path, evb_t::ptr ev = NULL, CLOSURE);
+
   //
   // set these for different HTTP response configurations;
   // should of course have more of them.
@@ -572,6 +605,8 @@ public:
 
   void set_demux_data(ptr<demux_data_t> d) override { _demux_data = d; }
 
+  void reinit (ptr<ahttpcon> x) override;
+
   virtual bool is_ssl() const;
   virtual str get_ip_str() const override;
 
@@ -603,8 +638,13 @@ private:
   void error_T (int n, const str &s, bool complete, evv_t::ptr ev, CLOSURE);
   void output_T (compressible_t *b, evv_t::ptr ev, CLOSURE);
   void redirect_T (const str &s, int status, evv_t::ptr ev, CLOSURE);
+  compressible_t::opts_t stream_delivery () const;
+  void output_stream_part (zbuf *z, zstream_state_t *st, bool last);
+  bool stream_backed_up ();
+  void stream_wait_for_room (evv_t ev);
 
-  ref<ahttpcon> _client_con;
+  ptr<ahttpcon> _client_con;  // NULL only while parked for recycling
+  ref<ahttpcon> client_con_ref () const { return mkref (&*_client_con); }
 
 protected:
   void set_attributes (http_resp_attributes_t *hra);
@@ -625,6 +665,7 @@ protected:
   ptr<vec<http_hdr_field_t> > hdr_fields;
 
   output_state_t output_state;
+  compressible_t::opts_t _stream_delivery;
   u_int _timeout;
   ptr<pub3::ok_iface_t> _p3_locale;
   ptr<demux_data_t> _demux_data;
@@ -666,6 +707,7 @@ public:
   void set_union_cgi_mode (bool b) override
   { http_parser_cgi_t::set_union_mode (b); }
 
+  void reinit (ptr<ahttpcon> x) override;
 };
 
 //-----------------------------------------------------------------------
@@ -684,7 +726,7 @@ public:
   void process() {}
   virtual void process(proc_ev_t ev) = 0;
   void send_complete() {}
-  void serve_complete() { delete this; }
+  void serve_complete() { release (); }
 
   // okclnt2_t allows use of keepalive connections, but only
   // if this flag is toggled to true...
@@ -725,6 +767,21 @@ template<> struct equals<dbcon_t*> {
 
 //-----------------------------------------------------------------------
 
+// A control channel to one of the extra okd accept workers (see 
+// OkdAcceptWorkers).  Those workers only hand us connections; all
+// other control traffic stays on the channel to the primary, on fd 0.
+struct okd_worker_con_t {
+  okd_worker_con_t (size_t i, int fd) : _id (i), _fd (fd) {}
+  void close () { _cli = NULL; _srv = NULL; _x = NULL; }
+  const size_t _id;
+  const int _fd;
+  ptr<axprt_unix> _x;
+  ptr<asrv> _srv;
+  ptr<aclnt> _cli;
+};
+
+//-----------------------------------------------------------------------
+
 class oksrvc_t : public ok_httpsrv_t, public ok_con_acceptor_t  { // OK Service
 public:
   oksrvc_t (int argc, char *argv[]);
@@ -765,8 +822,10 @@ public:
   void shutdown (bool end_of_okws_run, CLOSURE);
   void connect ();
   void ctldispatch (svccb *c);
+  void worker_dispatch (size_t i, svccb *c);
   void remove (okclnt_interface_t *c);
   void add (okclnt_interface_t *c);
+  void reclaim (okclnt_interface_t *c);
   void end_program (); 
 
   dbcon_t *add_db (const str &host, u_int port, const rpc_program &p);
@@ -801,7 +860,10 @@ protected:
 
   void launch_dbs (evb_t ev, CLOSURE);
 
-  void handle_new_con2 (svccb *sbp);
+  void handle_new_con2 (svccb *sbp, ptr<axprt_unix> x);
+  void handle_new_con_batch (svccb *sbp, ptr<axprt_unix> x);
+  okctl_sendcon_res_t handle_new_con_arg (const okctl_sendcon_arg2_t &arg,
+					  ptr<axprt_unix> x);
   void handle_get_stats (svccb *v);
   void handle_send_msg (svccb *sbp);
   void handle_diagnostic (svccb *sbp);
@@ -810,7 +872,8 @@ protected:
   void ready_call (bool rc);
 
   okctl_sendcon_res_t
-  handle_new_con_common (const okclnt_sin_t &sin_in, ptr<ahttpcon> *x_out);
+  handle_new_con_common (const okclnt_sin_t &sin_in, ptr<axprt_unix> cx,
+			 ptr<ahttpcon> *x_out);
 
   // debug initialization procedure
   void debug_launch (evv_t ev, CLOSURE);
@@ -831,8 +894,14 @@ protected:
   u_int n_reqs; // total number of requests served
   bool wait_for_signal_in_startup;
   int _n_newcli;
+
+  okclnt_interface_t *alloc_clnt (ptr<ahttpcon> x);
+  vec<okclnt_interface_t *> _clnt_pool;
+  u_int64_t _clnt_pool_hits, _clnt_pool_misses;
+
   size_t _brother_id;
   size_t _n_children;
+  vec<ptr<okd_worker_con_t> > _okd_workers;
   bool _aggressive_svc_restart;
   bool _die_on_logd_crash;
 
@@ -921,6 +990,9 @@ void timespec_to_xdr (const struct timespec &ts, okctl_timespec_t *x);
 void xdr_to_timespec (const okctl_timespec_t &x, struct timespec *ts);
 bool populate_keepalive_data (keepalive_data_t *d, 
 			      const okctl_sendcon_arg2_t &a);
+void hdr_index_to_xdr (const ahttp_hdr_index_t &in, okctl_hdr_index_t *out);
+ptr<ahttp_hdr_index_t> xdr_to_hdr_index (const okctl_hdr_index_t &in,
+					 const okctl_sendcon_arg2_t &a);
 
 //-----------------------------------------------------------------------
 
@@ -40,6 +40,8 @@ public:
     const okclnt3_t *ok_clnt () const { return _ok_clnt; }
 
     virtual bool want_raw_body() override { return _ok_clnt->want_raw_body(); }
+    virtual bool want_json_body() override
+    { return _ok_clnt->want_json_body(); }
   private:
     okclnt3_t *_ok_clnt;
   };
@@ -208,6 +210,10 @@ public:
   // yourself (e.g. as JSON).
   virtual bool want_raw_body() { return false; }
 
+  // Or true to have the body parsed as JSON as it arrives; see
+  // http_parser_full_t::get_json_body().
+  virtual bool want_json_body() { return false; }
+
   virtual bool ssl_only () const { return false; } 
   virtual str  ssl_redirect_str () const { return NULL; }
   bool is_ssl () const;
@@ -231,6 +237,7 @@ public:
   void set_union_cgi_mode (bool b) override { _union_cgi_mode = b; }
   void set_demux_data (ptr<demux_data_t> d) override { _demux_data = d; }
   virtual void serve () override { serve_T (); }
+  void reinit (ptr<ahttpcon> x) override;
 
   //------------------------------------------------------------------------
 
@@ -239,7 +246,7 @@ protected:
   //------------------------------------------------------------------------
 
   void serve_T (CLOSURE);
-  virtual void finish_serve () { delete this; }
+  virtual void finish_serve () { release (); }
 
   //-----------------------------------------------------------------------
   
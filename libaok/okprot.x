@@ -54,9 +54,28 @@ struct oksvc_status_t {
    unsigned uptime;
 };
 
+struct okctl_recycler_stat_t {
+  string name<>;
+  unsigned hyper hits;
+  unsigned hyper misses;
+};
+
+struct okctl_cache_stat_t {
+  string name<>;
+  unsigned hyper hits;
+  unsigned hyper misses;
+  unsigned hyper entries;
+  unsigned hyper bytes;
+};
+
 struct oksvc_stats_t {
   unsigned hyper n_sent;
   unsigned hyper n_recv;
+  unsigned hyper buf_pool_hits;
+  unsigned hyper buf_pool_misses;
+  unsigned hyper buf_pool_bytes;
+  okctl_recycler_stat_t recyclers<>;
+  okctl_cache_stat_t caches<>;
 };
 
 struct okctl_stats_t {
@@ -101,6 +120,30 @@ struct okctl_timespec_t {
        unsigned ts_nsec;
 };
 
+struct okctl_hdr_span_t {
+	unsigned off;
+	unsigned len;
+};
+
+struct okctl_hdr_field_t {
+	okctl_hdr_span_t key;
+	okctl_hdr_span_t val;
+};
+
+/*
+ * Offsets into the scraps for the request line and headers, as found
+ * by okd, so the service needn't parse the header again.
+ */
+struct okctl_hdr_index_t {
+	okctl_hdr_span_t mthd;
+	okctl_hdr_span_t target;
+	okctl_hdr_span_t *query;
+	okctl_hdr_span_t vers;
+	okctl_hdr_span_t line1;
+	unsigned hdr_len;
+	okctl_hdr_field_t fields<>;
+};
+
 struct okctl_sendcon_arg2_t {
 	opaque sin<>;
 	unsigned port;
@@ -109,6 +152,15 @@ struct okctl_sendcon_arg2_t {
  	okctl_timespec_t time_sent;
 	unsigned reqno; // >0 for keepalive connections
 	opaque scraps<>; // leftover bytes passed back in keepalive
+	okctl_hdr_index_t *hdr_index;
+};
+
+struct okctl_sendcon_batch_arg_t {
+	okctl_sendcon_arg2_t cons<>; // one FD sent for each, in order
+};
+
+struct okctl_sendcon_batch_res_t {
+	okctl_sendcon_res_t res<>;
 };
 
 struct okssl_sendcon_arg_t {
@@ -176,6 +228,26 @@ struct emergency_kill_arg_t {
      int signal;
 };
 
+struct okd_key_share_x_t {
+  string servpath<>;
+  unsigned brother_id;
+  unsigned hyper n_keyed;
+  unsigned hyper n_rekeyed;
+};
+
+struct okd_worker_stats_t {
+  unsigned worker_id;
+  unsigned hyper n_req;
+  unsigned hyper buf_pool_hits;
+  unsigned hyper buf_pool_misses;
+  unsigned hyper buf_pool_bytes;
+  okd_key_share_x_t key_shares<>;
+};
+
+struct okd_worker_stats_set_t {
+  okd_worker_stats_t workers<>;
+};
+
 %#define LOG_IP     (1 << 0)
 %#define LOG_UA     (1 << 1)
 %#define LOG_SZ     (1 << 2)
@@ -231,6 +303,9 @@ program OKCTL_PROGRAM {
 		okctl_sendcon_res_t
 		OKCTL_KEEPALIVE(okctl_sendcon_arg2_t) = 20;
 
+		okctl_sendcon_batch_res_t
+		OKCTL_SEND_CON_BATCH(okctl_sendcon_batch_arg_t) = 21;
+
 		void
 		OKCTL_KILL (oksig_t) = 99;
 
@@ -308,6 +383,12 @@ program OKLD_PROGRAM {
 		ok_xstatus_typ_t
 		OKLD_EMERGENCY_KILL(emergency_kill_arg_t) = 5;
 
+		okd_worker_stats_t
+		OKLD_GET_WORKER_STATS(void) = 6;
+
+		okd_worker_stats_set_t
+		OKLD_COLLECT_WORKER_STATS(void) = 7;
+
 	} = 1;
 
 } = 11279;
@@ -50,8 +50,16 @@ enum { XSSFILT_NONE = 0, XSSFILT_SOME = 1, XSSFILT_ALL = 2 };
 #define OKD_FDS_LOW_WAT_UL  0x100000
 #define OK_SVC_FD_QUOTA_LL 0
 #define OK_SVC_FD_QUOTA_UL 0x100000
+#define OKD_SENDCON_BATCH_LL 1
+#define OKD_SENDCON_BATCH_UL 253               // SCM_MAX_FD on Linux
+#define OKD_ACCEPT_WORKERS_LL 1
+#define OKD_ACCEPT_WORKERS_UL 64
 #define OK_RSL_LL 0
 #define OK_RSL_UL 10240
+#define OK_BPMB_LL 0
+#define OK_BPMB_UL 0x40000000
+#define OK_CRL_LL 0
+#define OK_CRL_UL 10240
 #define OK_SVC_FD_HIGH_WAT_UL 102400
 #define OK_SVC_FD_LOW_WAT_UL  100000
 
@@ -201,6 +209,9 @@ extern time_t ok_ahttpcon_zombie_timeout;      // how long to wait before warn
 extern time_t okd_emergency_kill_wait_time;    // time to emergency kill
 extern int okd_emergency_kill_signal;          // signal to send
 extern time_t okd_sendcon_time_budget;         // sending a con should be fast
+extern u_int okd_sendcon_batch_max;            // max cons per send RPC
+extern bool okd_send_hdr_index;                // send parsed hdr offsets
+extern u_int okd_accept_workers;               // N okd procs sharing ports
 
  
 
@@ -301,6 +312,17 @@ extern const char *ok_wheel;
 //
 extern u_int ok_recycle_suio_limit ;
 
+//
+// bytes of freed suiolite buffers to hold for reuse (0 => no pooling)
+//
+extern u_int ok_buf_pool_max_bytes;
+
+//
+// okclnt objects each service keeps for reuse, and likewise for its
+// ahttpcons and http_response_ok_t's (0 => delete them)
+//
+extern u_int ok_clnt_recycle_limit;
+
 //
 // pub2 constants
 //
@@ -331,12 +353,26 @@ extern size_t ok_pub3_profiler_buf_maxsize;
 // pub3 constants
 //
 extern bool ok_pub3_json_strict_escaping;
+extern bool ok_pub3_bytecode;
+extern bool ok_pub3_optimize;
+extern size_t ok_pub3_frag_cache_size;
+extern size_t ok_pub3_frag_cache_max_entry;
+extern int ok_pub3_frag_cache_ttl;
+extern size_t ok_pub3_stream_hiwat;
+extern bool ok_pub3_parallel;
+extern str ok_pub3_precompiled_dir;
+extern int ok_pub3_precompiled_lifetime;
+extern int ok_pub3_precompiled_clean_interval;
 extern size_t ok_pub3_yy_buffer_size;
 extern int ok_pub3_json_int_bitmax;
 extern size_t ok_pub3_recycle_limit_int;
 extern size_t ok_pub3_recycle_limit_bindtab;
 extern size_t ok_pub3_recycle_limit_dict;
 extern size_t ok_pub3_recycle_limit_slot;
+extern size_t ok_pub3_recycle_limit_str;
+extern size_t ok_pub3_recycle_limit_list;
+extern size_t ok_pub3_record_list_min;
+extern bool ok_pub3_msgpack_lazy;
 
 //-----------------------------------------------------------------------------
 
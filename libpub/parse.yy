@@ -11,6 +11,7 @@
 #include "pub3.h"
 #include "pscalar.h"
 #include "pub3parse.h"
+#include "pub3symtab.h"
 #include "okformat.h"
 
 #ifdef __clang__
@@ -36,6 +37,7 @@
 %token T_P3_BEGIN_EXPR
 %token T_P3_INCLUDE
 %token T_P3_LOAD
+%token T_P3_INCLUDE_CACHED
 %token T_P3_LOCALS
 %token T_P3_UNIVERSALS
 %token T_P3_GLOBALS
@@ -725,7 +727,7 @@ p3_binding: p3_bind_key p3_bind_value_opt
 	;
 
 p3_bind_key: p3_identifier    { $$ = $1; }
-        | p3_string_constant  { $$ = $1->to_str (); }
+        | p3_string_constant  { $$ = pub3::symtab_t::intern ($1->to_str ()); }
 	;
 
 p3_bindchar: ':' | '=' ;
@@ -825,6 +827,7 @@ p3_implicit_tuple:
 p3_include_or_load: 
           T_P3_INCLUDE { $$ = pub3::include_t::alloc (); }
         | T_P3_LOAD    { $$ = pub3::load_t::alloc (); }
+        | T_P3_INCLUDE_CACHED { $$ = pub3::cached_include_t::alloc (); }
 	;
 		   
 	
@@ -1001,7 +1004,9 @@ json_dict_pairs:
 
 json_dict_pair: T_P3_STRING ':' json_obj
       {
-         $$ = pub3::binding_t ($1, $3);
+         // keys from JSON input aren't added to the symtab; see
+         // pub3symtab.h
+         $$ = pub3::binding_t (pub3::symtab_t::lookup ($1), $3);
       }
       ;
 
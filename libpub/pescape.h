@@ -31,11 +31,74 @@
 #include "rxx.h"
 
 str json_escape (const str &s, bool qs, bool utf8 = false);
+str js_escape (const str &s, bool utf8 = false);
 str xss_escape (const char *s, size_t l);
 str xss_escape (const str &s);
 
 //-----------------------------------------------------------------------
 
+//
+// The escapers here are built on escape_kernel_t.  scan () finds the
+// next byte that needs escaping, 32 or 16 bytes at a time if the
+// compiler targets AVX2 or SSE2, and one at a time otherwise.  run ()
+// sizes its output exactly, then copies each clean run with a memcpy.
+//
+struct escape_rule_t {
+  char _c;
+  const char *_rep;  // as for escape_kernel_t::add ()
+};
+
+class escape_kernel_t {
+public:
+  // If ctl, all bytes below 0x20 or above 0x7f need escaping.
+  escape_kernel_t (bool ctl = false);
+
+  // The same, plus each of the rules in r.  The escapers each keep a
+  // function-local static kernel built this way, on first use.
+  template<size_t N>
+  explicit escape_kernel_t (const escape_rule_t (&r)[N], bool ctl = false)
+    : escape_kernel_t (ctl)
+  { for (size_t i = 0; i < N; i++) { add (r[i]._c, r[i]._rep); } }
+
+  // c needs escaping, as rep; if rep is NULL, c is just found, and
+  // then copied as is.
+  escape_kernel_t &add (char c, const char *rep = NULL);
+
+  // The offset of the first byte in p[0,len) that needs escaping, or
+  // len if none does.
+  size_t scan (const char *p, size_t len) const;
+  size_t scan_scalar (const char *p, size_t len) const;
+
+  // Escape p[0,len), wrapped in the quote q if it's not 0.
+  str run (const char *p, size_t len, char q = 0) const;
+
+  // The same, in two steps: how long the escaped p[0,len) will be,
+  // and then escaping it into out, which must have that much room.
+  // Returns the end of the output.
+  size_t escaped_len (const char *p, size_t len) const;
+  char *run_to (char *out, const char *p, size_t len) const;
+
+private:
+  enum { MAX_VEC_CHARS = 8 };
+  bool _ctl;
+  char _chars[MAX_VEC_CHARS];
+  size_t _nchars;
+  bool _vec;       // false once there are too many chars for scan ()
+  bool _hit[0x100];
+  const char *_rep[0x100];
+  size_t _replen[0x100];
+};
+
+//-----------------------------------------------------------------------
+
+// For json_escape's callers that write into their own buffers: the
+// kernel for the plain path, and whether s needs the wide path instead
+// (if utf8 isn't set).
+const escape_kernel_t &json_escape_kernel ();
+bool json_escape_needs_wide (const char *p, size_t len);
+
+//-----------------------------------------------------------------------
+
 class filter_buf_t {
 public:
   filter_buf_t () {}
@@ -13,7 +13,9 @@ public:
     _show_stats(false),
     _stats_interval(10000),
     _name(name),
-    _verbose(false) { reset_stats(); }
+    _verbose(false),
+    _n_hits(0),
+    _n_misses(0) { reset_stats(); }
 
   virtual ~recycler_stats_t () {}
 
@@ -22,11 +24,17 @@ public:
   void set_stats_interval(uint64_t interval) { _stats_interval = interval; }
   void set_verbose(bool verbose) { _verbose = verbose; }
 
+  // Lifetime counts, kept whether or not stats are shown.
+  const str &name() const { return _name; }
+  uint64_t hits() const { return _n_hits; }
+  uint64_t misses() const { return _n_misses; }
+
 protected:
   void reset_stats();
   void handle_event(size_t size);
   void alloc_hook(bool can_alloc, size_t size);
   void recycle_hook(bool can_recycle, size_t size);
+  void tally(bool hit) { if (hit) _n_hits++; else _n_misses++; }
 
   bool _show_stats;
   uint64_t _stats_interval;
@@ -39,6 +47,8 @@ protected:
   size_t _max_size_seen;
   double _list_size_sum;
   uint64_t _num_avg_samples;
+  uint64_t _n_hits;
+  uint64_t _n_misses;
 };
 
 //-----------------------------------------------------------------------------
@@ -59,6 +69,7 @@ public:
   {
     ptr<T> ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _v.pop_back ();
@@ -74,6 +85,7 @@ public:
   {
     ptr<T> ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _v.pop_back ();
@@ -89,6 +101,7 @@ public:
   {
     ptr<T> ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _v.pop_back ();
@@ -104,6 +117,7 @@ public:
   {
     ptr<T> ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _v.pop_back ();
@@ -153,6 +167,7 @@ public:
   {
     T * ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _vp.pop_back ();
@@ -168,6 +183,7 @@ public:
   {
     T * ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _vp.pop_back ();
@@ -183,6 +199,7 @@ public:
   {
     T *ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _vp.pop_back ();
@@ -198,6 +215,7 @@ public:
   {
     T * ret;
     bool b = can_alloc();
+    tally(b);
     if (show_stats()) { alloc_hook(b, size()); }
     if (b) {
       ret = _vp.pop_back ();
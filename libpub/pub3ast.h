@@ -9,11 +9,17 @@
 #include "okformat.h"
 #include "pub3expr.h"
 #include "pub3obj.h"
+#include "pub3bytecode.h"
+#include "pub3parallel.h"
 
 namespace pub3 {
 
   //-----------------------------------------------------------------------
 
+  class optimizer_t;  // declared in pub3opt.h
+
+  //-----------------------------------------------------------------------
+
   class ast_node_t : public virtual refcount, public virtual dumpable_t {
   public: 
     ast_node_t (location_t l) : _location (l) {}
@@ -26,6 +32,9 @@ namespace pub3 {
 
     bool might_block () const;
     virtual void propogate_metadata (ptr<const metadata_t> md);
+
+    // Load-time simplification of this node and its children; see pub3opt.h
+    virtual void optimize (optimizer_t *o) {}
   protected:
     virtual bool might_block_uncached () const = 0;
 
@@ -56,6 +65,10 @@ namespace pub3 {
     virtual ptr<zone_text_t> zone_text () { return NULL; }
     virtual bool to_xdr (xpub3_zone_t *z) const = 0;
 
+    // If this zone's output never varies, get it, both as is and
+    // white-space stripped.
+    virtual bool static_text (zstr *orig, zstr *wss) const { return false; }
+
     static ptr<zone_t> alloc (const xpub3_zone_t &z);
     static ptr<zone_t> alloc (const xpub3_zone_t *z);
   protected:
@@ -89,6 +102,7 @@ namespace pub3 {
     bool to_xdr (xpub3_zone_t *z) const;
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "zone_raw_t"; }
+    bool static_text (zstr *orig, zstr *wss) const;
   protected:
     bool might_block_uncached () const;
     status_t v_publish_nonblock (eval_t *p) const;
@@ -102,6 +116,9 @@ namespace pub3 {
   class zone_text_t : public zone_t {
   public:
     zone_text_t (location_t l) : zone_t (l) {}
+    zone_text_t (lineno_t l, zstr orig, zstr wss)
+      : zone_t (l), _original (orig), _wss (wss)
+    { precompress (_original); precompress (_wss); }
     zone_text_t (const xpub3_zone_text_t &z);
 
     static ptr<zone_text_t> alloc ();
@@ -119,10 +136,12 @@ namespace pub3 {
     bool might_block_uncached () const { return false; }
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "zone_text_t"; }
+    bool static_text (zstr *orig, zstr *wss) const;
   protected:
     status_t v_publish_nonblock (eval_t *p) const;
     void v_publish (eval_t *p, status_ev_t ev, CLOSURE) const;
     void cook_text () const;
+    static void precompress (const zstr &z);
 
     // while parsing, use the following representation:
     strbuf _b;
@@ -174,6 +193,7 @@ namespace pub3 {
     bool to_xdr (xpub3_zone_t *z) const;
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "zone_html_t"; }
+    void optimize (optimizer_t *o);
 
   protected:
     bool might_block_uncached () const;
@@ -196,11 +216,14 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "zone_inline_expr_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
+    bool static_text (zstr *orig, zstr *wss) const;
   protected:
     status_t v_publish_nonblock (eval_t *p) const;
     void v_publish (eval_t *p, status_ev_t ev, CLOSURE) const;
     void null_warn (eval_t *p) const;
     ptr<expr_t> _expr;
+    bc_expr_t _bc;
   };
 
   //-----------------------------------------------------------------------
@@ -231,11 +254,13 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "zone_pub_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
     
   protected:
     status_t v_publish_nonblock (eval_t *p) const;
     void v_publish (eval_t *p, status_ev_t ev, CLOSURE) const;
     vec<ptr<statement_t> > _statements;
+    par_plan_t _par;
   };
 
   //-----------------------------------------------------------------------
@@ -246,6 +271,7 @@ namespace pub3 {
     statement_t (lineno_t l) : ast_node_t (l) {}
     virtual bool to_xdr (xpub3_statement_t *x) const = 0;
     static ptr<statement_t> alloc (const xpub3_statement_t &x);
+    virtual ptr<const expr_t> to_expr () const { return NULL; }
   };
 
   //-----------------------------------------------------------------------
@@ -264,6 +290,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "statement_zone_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
   protected:
     ptr<zone_t> _zone;
   };
@@ -285,6 +312,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "expr_statement_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    ptr<const expr_t> to_expr () const { return _expr; }
   protected:
     ptr<expr_t> _expr;
   };
@@ -309,6 +337,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "while_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
   protected:
     ptr<expr_t> _cond;
     ptr<zone_t> _body;
@@ -339,6 +368,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "for_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
   protected:
     ptr<expr_list_t> eval_list (eval_t *p) const;
     void pub_list (eval_t *p, xlev_t ev, CLOSURE) const;
@@ -379,12 +409,14 @@ namespace pub3 {
     lineno_t dump_get_lineno () const { return _lineno; }
     void v_dump (dumper_t *d) const;
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
 
   private:
     lineno_t _lineno;
     ptr<expr_t> _expr;
     ptr<zone_t> _body;
     mutable tri_bool_t _might_block;
+    bc_expr_t _bc;
   };
 
   //-----------------------------------------------------------------------
@@ -411,6 +443,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "if_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
   private:
     ptr<const zone_t> find_clause (eval_t *p) const;
     void find_clause (eval_t *p, czev_t ev, CLOSURE) const;
@@ -437,6 +470,7 @@ namespace pub3 {
     ptr<bindlist_t> _bindings;
     ptr<expr_dict_t> _tab;
     mutable tri_bool_t _static;
+    par_plan_t _par;
   };
 
   //-----------------------------------------------------------------------
@@ -536,6 +570,7 @@ namespace pub3 {
     void v_dump (dumper_t *d) const;
     const char *get_obj_name () const { return "switch_t"; }
     virtual void propogate_metadata (ptr<const metadata_t> md);
+    void optimize (optimizer_t *o);
   protected:
     ptr<const zone_t> find_case (eval_t *pub) const;
     bool populate_cases ();
@@ -564,6 +599,8 @@ namespace pub3 {
     virtual void propogate_metadata (ptr<const metadata_t> md);
   protected:
     bool to_xdr_base (xpub3_statement_t *x, xpub3_statement_typ_t typ) const;
+    virtual str fragment_key (eval_t *p, ptr<const bind_interface_t> bi) 
+      const { return NULL; }
     ptr<expr_t> _file;
     ptr<expr_t> _dict;
   };
@@ -583,6 +620,26 @@ namespace pub3 {
 
   //-----------------------------------------------------------------------
 
+  //
+  // As include, but the output is cached (see pub3fragment.h), and
+  // reused for the same file and arguments.  For files whose output
+  // depends only on their arguments; any other side effects they have
+  // are lost on a cache hit.
+  //
+  class cached_include_t : public include_t {
+  public:
+    cached_include_t (location_t l) : include_t (l) {}
+    cached_include_t (const xpub3_include_t &x);
+    bool to_xdr (xpub3_statement_t *x) const;
+    str fnname () const { return "include_cached"; }
+    static ptr<cached_include_t> alloc ();
+    const char *get_obj_name () const { return "cached_include_t"; }
+  protected:
+    str fragment_key (eval_t *p, ptr<const bind_interface_t> bi) const;
+  };
+
+  //-----------------------------------------------------------------------
+
   class print_t : public statement_t {
   public:
     print_t (location_t l) : statement_t (l) {}
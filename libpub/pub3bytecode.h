@@ -0,0 +1,124 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3expr.h"
+#include "pub3eval.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // pub3 bytecode
+  //
+  //   An optional lowering of non-blocking expression trees into a flat
+  //   array of register-based instructions.  Leaves the AST intact; any
+  //   node that doesn't know how to compile itself is embedded as a
+  //   BC_EVAL instruction, which calls back into eval_to_val().  Things
+  //   that might block are never compiled, and stay on the tamed
+  //   pub_to_val() path.
+  //
+  //   Every instruction writes its result to register _dst; _a and _b
+  //   are source registers, and _arg indexes the node pool or is a
+  //   jump target.
+  //
+  //-----------------------------------------------------------------------
+
+  typedef enum {
+    BC_CONST = 0,      // dst <- nodes[arg]
+    BC_EVAL = 1,       // dst <- nodes[arg]->eval_to_val ()
+    BC_VARREF = 2,     // dst <- lookup of varref nodes[arg]
+    BC_DICTREF = 3,    // dst <- a[key of dictref nodes[arg]]
+    BC_VECREF = 4,     // dst <- a[b], for vecref nodes[arg]
+    BC_BINOP = 5,      // dst <- binary op nodes[arg] over (a, b)
+    BC_EQ = 6,         // dst <- (a == b), for EQ node nodes[arg]
+    BC_RELATION = 7,   // dst <- (a <op> b), for relation nodes[arg]
+    BC_TRUTH = 8,      // dst <- bool (a)
+    BC_NOT = 9,        // dst <- !bool (a)
+    BC_JMP_FALSE = 10, // if !bool (a), goto arg
+    BC_JMP_TRUE = 11,  // if bool (a), goto arg
+    BC_SILENT = 12,    // push the eval's silent flag, and set it
+    BC_UNSILENT = 13   // restore the eval's silent flag
+  } bc_opcode_t;
+
+  //-----------------------------------------------------------------------
+
+  struct bc_insn_t {
+    bc_insn_t (bc_opcode_t o, bc_reg_t d, bc_reg_t a, bc_reg_t b, u_int32_t g)
+      : _op (o), _dst (d), _a (a), _b (b), _arg (g) {}
+    bc_opcode_t _op;
+    bc_reg_t _dst, _a, _b;
+    u_int32_t _arg;
+  };
+
+  //-----------------------------------------------------------------------
+
+  class bytecode_t {
+  public:
+    bytecode_t () : _nregs (0), _result (0) {}
+
+    ptr<const expr_t> eval_to_val (eval_t *e) const;
+    bool eval_as_bool (eval_t *e) const;
+    str eval_as_str (eval_t *e) const;
+
+    size_t n_insns () const { return _code.size (); }
+
+    friend class bc_compiler_t;
+  private:
+    enum { SMALL_NREGS = 16 };
+    void run (eval_t *e, ptr<const expr_t> *regs) const;
+
+    vec<bc_insn_t> _code;
+    vec<ptr<const expr_t> > _nodes;  // slot 0 is always NULL
+    size_t _nregs;
+    bc_reg_t _result;
+  };
+
+  //-----------------------------------------------------------------------
+
+  //
+  // The compiler hands out registers in stack order: a node computes into
+  // the register it's given, and borrows scratch registers from above it
+  // for its operands.
+  //
+  class bc_compiler_t {
+  public:
+    bc_compiler_t ();
+
+    static ptr<const bytecode_t> compile (const expr_t &x);
+
+    void compile (ptr<const expr_t> x, bc_reg_t dst);
+    void compile_bool (ptr<const expr_t> x, bc_reg_t dst);
+    size_t emit (bc_opcode_t op, bc_reg_t dst, bc_reg_t a = 0,
+		 bc_reg_t b = 0, u_int32_t arg = 0);
+    u_int32_t add_node (ptr<const expr_t> x);
+    bc_reg_t push_reg ();
+    void pop_reg () { _top--; }
+    size_t here () const { return _bc->_code.size (); }
+    void patch (size_t insn, size_t target);
+  private:
+    ptr<bytecode_t> _bc;
+    bc_reg_t _top;
+  };
+
+  //-----------------------------------------------------------------------
+
+  //
+  // A statement's handle on its expression's bytecode, compiled the first
+  // time the statement is published, if ok_pub3_bytecode is on.
+  //
+  class bc_expr_t {
+  public:
+    bc_expr_t () : _tried (false) {}
+    ptr<const expr_t> eval_to_val (eval_t *e, const expr_t &x) const;
+    bool eval_as_bool (eval_t *e, const expr_t &x) const;
+    str eval_as_str (eval_t *e, const expr_t &x) const;
+  private:
+    ptr<const bytecode_t> get (const expr_t &x) const;
+    mutable ptr<const bytecode_t> _bc;
+    mutable bool _tried;
+  };
+
+  //-----------------------------------------------------------------------
+};
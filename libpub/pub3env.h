@@ -41,6 +41,10 @@ namespace pub3 {
     ptr<const expr_t> lookup_val (const str &nm) const;
     size_t stack_size () const;
     ptr<mref_t> lookup_ref (const str &nm) const;
+
+    // As above, with h = bindtab_t::hash_key (nm), precomputed by the caller
+    ptr<const expr_t> lookup_val (const str &nm, hash_t h) const;
+    ptr<mref_t> lookup_ref (const str &nm, hash_t h) const;
     void add_global_binding (const str &nm, ptr<expr_t> v);
 
     ptr<bindtab_t> library () { return _library; }
@@ -103,7 +107,7 @@ namespace pub3 {
     ptr<expr_list_t> to_list () const;
     
   protected:
-    size_t dec_stack_pointer (stack_layer_t l, size_t i) const;
+    size_t dec_stack_pointer (const stack_layer_t &l, size_t i) const;
     ssize_t descend_to_barrier () const;
 
     ptr<bindtab_t> _library;
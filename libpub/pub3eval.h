@@ -186,6 +186,8 @@ namespace pub3 {
 
     ptr<const expr_t> lookup_val (const str &nm) const;
     ptr<mref_t> lookup_ref (const str &nm) const;
+    ptr<const expr_t> lookup_val (const str &nm, hash_t h) const;
+    ptr<mref_t> lookup_ref (const str &nm, hash_t h) const;
 
     location_t location (lineno_t l) const;
     bool push_muzzle (bool b);
@@ -219,6 +221,11 @@ namespace pub3 {
     ptr<ok_iface_t> pub_iface () { return _pub_iface; }
 
     void clear_me (ptr<expr_t> x) { _to_clear.push_back (x); }
+
+    // The next file published should come from, or go into, the
+    // fragment cache, under this key (see cached_include_t).
+    void set_fragment_key (str k) { _fragment_key = k; }
+    str take_fragment_key (ptr<const metadata_t> md);
     const loc_stack_t *get_loc_stack () const { return &_stack; }
 
   protected:
@@ -241,6 +248,7 @@ namespace pub3 {
     str _cwd;
     ptr<ok_iface_t> _pub_iface;  // publisher interface
     vec<ptr<expr_t> > _to_clear; // to clear on dealloc to clear cycles
+    str _fragment_key;
 
   };
 
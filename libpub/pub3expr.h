@@ -27,11 +27,14 @@ namespace pub3 {
   class expr_assignment_t;
   class expr_dict_t;
   class expr_list_t;
+  class expr_record_t; // declared in pub3records.h
   class bindtab_t;
   class bind_interface_t;
   class call_t;      // declared in pub3func.h
   class callable_t;  // declared in pub3func.h -- a custom-defined function
   class metadata_t;  // declared in pub3file.h
+  class bc_compiler_t; // declared in pub3bytecode.h
+  class json_writer_t; // declared in pub3json.h
   namespace msgpack {
     class outbuf_t;   // declared in pub3msgpack.h
   };
@@ -45,6 +48,7 @@ namespace pub3 {
   typedef event<ptr<expr_list_t> >::ref xlev_t;
   typedef event<ptr<expr_dict_t> >::ref xdev_t;
   typedef event<ptr<mref_t> >::ref mrev_t;
+  typedef u_int16_t bc_reg_t;
 
 
   //-----------------------------------------------------------------------
@@ -82,6 +86,7 @@ namespace pub3 {
     virtual bool to_xdr (xpub3_expr_t *x) const = 0;
     virtual bool to_xdr (xpub3_json_t *x) const;
     virtual bool to_msgpack (msgpack::outbuf_t *b) const { return false; }
+    virtual void to_json (json_writer_t *w) const;  // see pub3json.h
 
     //returns the docstring associated with a value.
     virtual const str* documentation () const { return NULL; };
@@ -106,6 +111,10 @@ namespace pub3 {
     virtual ptr<mref_t> eval_to_ref (eval_t *e) const;
     virtual ptr<bind_interface_t> eval_to_bindtab (eval_t *e) const;
     virtual ptr<expr_t> eval_to_mval (eval_t *e) const;
+
+    // Lower this (non-blocking) expression into bytecode that leaves
+    // its value in register dst; see pub3bytecode.h
+    virtual void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
     //
     //------------------------------------------------------------
 
@@ -117,6 +126,14 @@ namespace pub3 {
     virtual void cycle_clear () {} // clear for cycle-elimination
 
     virtual bool is_static () const { return false; }
+
+    // Whether this expression's value can be computed once, at load
+    // time; broader than is_static(), see pub3opt.h
+    virtual bool is_constant_expr () const { return is_static (); }
+
+    // Add the names of the variables this expression reads to out;
+    // false if we can't tell, see pub3parallel.h
+    virtual bool free_vars (vec<str> *out) const { return is_static (); }
     bool might_block () const;
     virtual bool might_block_uncached () const { return false; }
     static bool might_block (ptr<const expr_t> x1, ptr<const expr_t> x2 = NULL);
@@ -155,6 +172,10 @@ namespace pub3 {
     virtual ptr<const expr_list_t> to_list () const { return NULL; }
     virtual ptr<expr_list_t> to_list () { return NULL; }
 
+    // A row of a record list, which can be read as a dict without
+    // making one; see pub3records.h
+    virtual ptr<const expr_record_t> to_record () const { return NULL; }
+
     virtual str to_identifier () const { return NULL; }
     virtual str to_str (PUB3_TO_STR_ARG) const { return NULL; }
     virtual str to_switch_str () const { return to_str (); }
@@ -165,6 +186,7 @@ namespace pub3 {
     virtual bool to_len (size_t *s) const { return false; }
     virtual bool is_null () const { return false; }
     virtual bool is_str () const { return false; }
+    virtual bool is_int () const { return false; }  // an expr_int_t proper
     virtual ptr<rxx> to_regex (str *errp = NULL) const { return NULL; }
     virtual ptr<expr_regex_t> to_regex_obj () { return NULL; }
     virtual str type_to_str () const { return "object"; }
@@ -182,6 +204,8 @@ namespace pub3 {
     virtual ptr<call_t> coerce_to_call () ;
     virtual ptr<const callable_t> to_callable () const { return NULL; }
     virtual bool is_call_coercable () const { return true; }
+    virtual ptr<const call_t> to_call () const { return NULL; }
+    virtual const expr_assignment_t *to_assignment () const { return NULL; }
 
     // Only used for recycling
     virtual void init() { _lineno = 0; _might_block.reset(); }
@@ -221,12 +245,14 @@ namespace pub3 {
     ptr<const expr_dict_t> to_dict () const;
     ptr<expr_list_t> to_list ();
     ptr<const expr_list_t> to_list () const;
+    ptr<const expr_record_t> to_record () const;
     bool to_xdr (xpub3_expr_t *x) const;
     bool to_xdr (xpub3_json_t *x) const;
     bool to_msgpack (msgpack::outbuf_t *b) const;
     bool is_static () const;
     bool might_block_uncached () const;
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     virtual const str* documentation () const;
     ptr<const callable_t> to_callable () const;
     const char *get_obj_name () const { return "pub3::expr_cow_t"; }
@@ -316,6 +342,7 @@ namespace pub3 {
     bool is_static () const { return true; }
     bool is_call_coercable () const { return false; }
     virtual void v_dump (dumper_t *d) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
   };
 
   //----------------------------------------------------------------------
@@ -332,6 +359,7 @@ namespace pub3 {
     str type_to_str () const { return "null"; }
     void v_dump (dumper_t *d) const;
     str to_str (PUB3_TO_STR_ARG) const { return "null"; }
+    void to_json (json_writer_t *w) const;
     str arg_to_str () const { return ""; }
   };
 
@@ -347,6 +375,7 @@ namespace pub3 {
     static ptr<expr_bool_t> alloc (bool b);
     static str static_to_str (bool b);
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     str to_switch_str () const { return _b ? "1" : "0"; }
     ptr<expr_t> copy () const;
     bool to_bool () const { return _b; }
@@ -393,7 +422,10 @@ namespace pub3 {
     bool to_xdr (xpub3_expr_t *x) const;
     const char *get_obj_name () const { return "pub3::expr_OR_t"; }
     bool might_block_uncached () const { return might_block (_t1, _t2); }
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
     void v_dump (dumper_t *d) const { l_dump (d, _t1, _t2); }
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
   protected:
     bool eval_logical (eval_t *e) const;
     void pub_logical (eval_t *p, evb_t, CLOSURE) const;
@@ -413,6 +445,9 @@ namespace pub3 {
     const char *get_obj_name () const { return "pub3::expr_AND_t"; }
     void v_dump (dumper_t *d) const { l_dump (d, _f1, _f2); }
     bool might_block_uncached () const { return might_block (_f1, _f2); }
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
   protected:
     ptr<expr_t> _f1, _f2;
     bool eval_logical (eval_t *e) const;
@@ -431,6 +466,9 @@ namespace pub3 {
     bool to_xdr (xpub3_expr_t *x) const;
     const char *get_obj_name () const { return "pub3::expr_NOT_t"; }
     bool might_block_uncached () const { return _e && _e->might_block (); }
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
   protected:
     ptr<expr_t> _e;
     bool eval_logical (eval_t *e) const;
@@ -450,8 +488,12 @@ namespace pub3 {
     const char *get_obj_name () const { return "pub3::expr_EQ_t"; }
     void v_dump (dumper_t *d) const { l_dump (d, _o1, _o2); }
     bool might_block_uncached () const { return might_block (_o1, _o2); }
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
     static bool eval_static (ptr<const expr_t> x1, ptr<const expr_t> x2, 
 			     bool pos = true);
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    friend class bytecode_t;
   protected:
     ptr<expr_t> _o1, _o2;
     bool _pos;
@@ -477,11 +519,15 @@ namespace pub3 {
     bool is_call_coercable () const { return false; }
     void v_dump (dumper_t *d) const { l_dump (d, _l, _r); }
     bool might_block_uncached () const { return might_block (_l, _r); }
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
 
     static bool eval_final (eval_t *e, ptr<const expr_t> l, 
 			    ptr<const expr_t> r, 
 			    xpub3_relop_t op, 
 			    const expr_t *self);
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    friend class bytecode_t;
   protected:
     ptr<expr_t> _l, _r;
     xpub3_relop_t _op;
@@ -509,9 +555,13 @@ namespace pub3 {
     ptr<const expr_t> eval_to_val (eval_t *e) const;
     void pub_to_val (eval_t *pub, cxev_t ev, CLOSURE) const;
     bool might_block_uncached () const;
+    bool is_constant_expr () const;
+    bool free_vars (vec<str> *out) const;
     bool to_xdr (xpub3_expr_t *x) const;
     bool is_call_coercable () const { return false; }
     void v_dump (dumper_t *d) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    friend class bytecode_t;
   protected:
 
     virtual ptr<const expr_t> 
@@ -607,6 +657,8 @@ namespace pub3 {
     expr_ref_t (lineno_t l) : expr_t (l) {}
     ptr<expr_t> eval_to_mval (eval_t *e) const;
     void pub_to_mval (eval_t *p, xev_t ev, CLOSURE) const;
+  protected:
+    static hash_t hash_name (const str &s);   // bindtab_t::hash_key, or 0
   };
 
   //-----------------------------------------------------------------------
@@ -614,7 +666,8 @@ namespace pub3 {
   class expr_dictref_t : public expr_ref_t {
   public:
     expr_dictref_t (ptr<expr_t> d, const str &k, lineno_t lineno)
-      : expr_ref_t (lineno), _dict (d), _key (k) {}
+      : expr_ref_t (lineno), _dict (d), _key (k),
+	_hash (hash_name (k)) {}
     expr_dictref_t (const xpub3_dictref_t &x);
     static ptr<expr_dictref_t> alloc (ptr<expr_t> d, const str &k);
     bool to_xdr (xpub3_expr_t *x) const;
@@ -628,19 +681,24 @@ namespace pub3 {
     ptr<mref_t> eval_to_ref (eval_t *e) const;
     void pub_to_ref (eval_t *pub, mrev_t ev, CLOSURE) const;
     void pub_to_val (eval_t *pub, cxev_t ev, CLOSURE) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    bool free_vars (vec<str> *out) const;
+    friend class bytecode_t;
   protected:
     bool might_block_uncached () const;
     ptr<mref_t> eval_to_ref_final (eval_t *e, ptr<mref_t> dr) const;
     ptr<const expr_t> eval_to_val_final (eval_t *e, ptr<const expr_t> d) const;
     ptr<expr_t> _dict;
     str _key;
+    hash_t _hash;  // of _key, as in expr_varref_t
   };
 
   //-----------------------------------------------------------------------
 
   class expr_varref_t : public expr_ref_t {
   public:
-    expr_varref_t (const str &s, lineno_t l) : expr_ref_t (l), _name (s) {}
+    expr_varref_t (const str &s, lineno_t l) 
+      : expr_ref_t (l), _name (s), _hash (hash_name (s)) {}
     expr_varref_t (const xpub3_ref_t &x);
     virtual bool to_xdr (xpub3_expr_t *x) const;
     str to_identifier () const { return _name; }
@@ -653,8 +711,12 @@ namespace pub3 {
     void pub_to_val (eval_t *p, cxev_t ev, CLOSURE) const;
     void v_dump (dumper_t *d) const;
     void report (eval_t *e, bool is_defined) const;
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    bool free_vars (vec<str> *out) const;
+    friend class bytecode_t;
   protected:
     str _name;
+    hash_t _hash;  // of _name, computed once rather than on every lookup
   };
 
   //-----------------------------------------------------------------------
@@ -705,6 +767,9 @@ namespace pub3 {
     virtual const str* documentation () const {
       return _vec->documentation ();
     }
+    void to_bytecode (bc_compiler_t *c, bc_reg_t dst) const;
+    bool free_vars (vec<str> *out) const;
+    friend class bytecode_t;
 
   protected:
     bool might_block_uncached () const;
@@ -726,6 +791,7 @@ namespace pub3 {
 
     bool is_str () const { return true; }
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     bool to_bool () const;
     scalar_obj_t to_scalar () const;
     bool to_null () const;
@@ -753,6 +819,7 @@ namespace pub3 {
 
     bool is_str () const { return true; }
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     bool to_bool () const;
     scalar_obj_t to_scalar () const;
     bool to_null () const;
@@ -773,8 +840,12 @@ namespace pub3 {
     bool to_uint (u_int64_t *u) const;
     bool to_int (int64_t *u) const;
 
+    // need this only to implement recycling
+    void init (const str &s) { expr_t::init (); _val = s; }
+    void finalize ();
+
   protected:
-    const str _val;
+    str _val;
   };
 
   //-----------------------------------------------------------------------
@@ -792,6 +863,7 @@ namespace pub3 {
     expr_int_t (const xpub3_int_t &x);
 
     bool to_bool () const { return _val; }
+    bool is_int () const { return true; }
     scalar_obj_t to_scalar () const;
     int64_t to_int () const { return _val; }
     bool to_int (int64_t *i) const { *i = _val; return true; }
@@ -801,6 +873,7 @@ namespace pub3 {
     bool to_msgpack (msgpack::outbuf_t *x) const;
     const char *get_obj_name () const { return "pub3::expr_int_t"; }
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     double to_double () const;
     bool to_double (double *out) const;
 
@@ -831,6 +904,7 @@ namespace pub3 {
     bool to_int (int64_t *i) const;
     bool to_uint (u_int64_t *u) const { *u = _val; return true; }
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     double to_double () const;
     bool to_double (double *out) const;
 
@@ -860,6 +934,7 @@ namespace pub3 {
     bool to_double (double *d) const;
     scalar_obj_t to_scalar () const;
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     int64_t to_int () const;
     bool to_int (int64_t *out) const;
 
@@ -910,13 +985,13 @@ namespace pub3 {
     ptr<rxx> to_regex (eval_t *e = NULL) const;
     scalar_obj_t to_scalar () const;
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
     void v_dump (dumper_t *d) const;
     void push_front (ptr<expr_t> e);
 
     static ptr<expr_list_t> alloc ();
     static ptr<expr_list_t> parse_alloc ();
-    static ptr<expr_list_t> alloc (lineno_t l) 
-    { return New refcounted<expr_list_t> (l); }
+    static ptr<expr_list_t> alloc (lineno_t l);
     static ptr<expr_list_t> alloc (const xpub3_expr_list_t &x) 
     { return New refcounted<expr_list_t> (x); }
     static ptr<expr_list_t> alloc (const xpub3_expr_list_t *x);
@@ -933,9 +1008,16 @@ namespace pub3 {
     void pub_to_val (eval_t *p, cxev_t ev, CLOSURE) const;
     void pub_to_mval (eval_t *p, xev_t ev, CLOSURE) const;
     bool is_static () const;
+    bool free_vars (vec<str> *out) const;
     bool might_block_uncached () const;
     bool is_call_coercable () const { return false; }
     void propogate_metadata (ptr<const metadata_t> md);
+
+    // Used only for recycling
+    void init () { expr_t::init (); vec_base_t::clear (); _static.reset (); }
+    void init (lineno_t lineno) { init (); _lineno = lineno; }
+    void finalize ();
+
   private:
     bool fixup_index (ssize_t *ind, bool lax = false) const;
     mutable tri_bool_t _static;
@@ -1026,6 +1108,11 @@ namespace pub3 {
   public:
     virtual bool lookup (const str &nm, ptr<const expr_t> *x = NULL)
       const = 0;
+
+    // As above, but with nm's hash precomputed by bindtab_t::hash_key
+    virtual bool lookup_hashed (const str &nm, hash_t h, 
+				ptr<const expr_t> *x = NULL) const
+    { return lookup (nm, x); }
     virtual ~bind_interface_t () {}
     virtual ptr<bindtab_t> mutate () = 0;
     virtual ptr<qhash_const_iterator_t<str, ptr<expr_t> > > iter() const = 0;
@@ -1071,6 +1158,9 @@ namespace pub3 {
     bindtab_t &operator+= (const bindtab_t &in);
     bindtab_t &operator-= (const bindtab_t &in);
     bool lookup (const str &nm, ptr<const expr_t> *x = NULL) const;
+    bool lookup_hashed (const str &nm, hash_t h, 
+			ptr<const expr_t> *x = NULL) const;
+    static hash_t hash_key (const str &k) { return hashfn<str> () (k); }
     ptr<bindtab_t> mutate () { return mkref (this); }
     typedef qhash_const_iterator_t<str, ptr<expr_t> > const_iterator_t;
     typedef qhash_iterator_t<str, ptr<expr_t> > iterator_t;
@@ -1108,6 +1198,8 @@ namespace pub3 {
     virtual ~cow_bindtab_t () {}
     static ptr<cow_bindtab_t> alloc (ptr<const bindtab_t> t);
     bool lookup (const str &nm, ptr<const expr_t> *x = NULL) const;
+    bool lookup_hashed (const str &nm, hash_t h, 
+			ptr<const expr_t> *x = NULL) const;
     ptr<bindtab_t> mutate ();
     ptr<bindtab_t::const_iterator_t> iter () const;
   protected:
@@ -1148,6 +1240,7 @@ namespace pub3 {
     // To JSON-style string
     scalar_obj_t to_scalar () const;
     str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
 
     ptr<expr_t> lookup (str k);
     ptr<const expr_t> lookup (str k) const;
@@ -1189,6 +1282,7 @@ namespace pub3 {
     ptr<expr_t> cow_copy () const;
     ptr<expr_dict_t> copy_dict () const;
     bool is_static () const;
+    bool free_vars (vec<str> *out) const;
     bool might_block_uncached () const;
     void propogate_metadata (ptr<const metadata_t> md);
 
@@ -1225,6 +1319,12 @@ namespace pub3 {
     void pub_to_val (eval_t *pub, cxev_t ev, CLOSURE) const;
     void v_dump (dumper_t *d) const;
     void propogate_metadata (ptr<const metadata_t> md);
+    const expr_assignment_t *to_assignment () const { return this; }
+    ptr<const expr_t> lhs () const { return _lhs; }
+    ptr<const expr_t> rhs () const { return _rhs; }
+
+    // Assign an already-computed RHS; for a non-blocking LHS only.
+    ptr<mref_t> assign (eval_t *e, ptr<expr_t> rhs) const;
   private:
     ptr<mref_t> eval_to_ref_final (eval_t *e, ptr<mref_t> lhs,
 				   ptr<expr_t> rhs) const;
@@ -1249,6 +1349,8 @@ namespace pub3 {
   recycler_t<bindtab_t> * get_bindtab_recycler();
   recycler_t<expr_int_t> * get_int_recycler();
   recycler_t<expr_dict_t> * get_dict_recycler();
+  recycler_t<expr_str_t> * get_str_recycler();
+  recycler_t<expr_list_t> * get_list_recycler();
   // Defined above
   //nonref_recycler_t<qhash_slot<str, ptr<expr_t> > > * get_slot_recycler();
   
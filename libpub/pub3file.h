@@ -103,6 +103,7 @@ namespace pub3 {
     ssize_t xdr_len () const;
     ssize_t get_chunk (size_t offset, char *buf, size_t capacity) const;
     void get_xdr_hash (xpub3_hash_t *x) const;
+    str xdr_opaque () const { return _xdr_opaque; }
     opts_t opts () const { return _opts; }
 
   protected:
@@ -0,0 +1,65 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "async.h"
+#include "ihash.h"
+#include "list.h"
+#include "zstr.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // fragment_cache_t
+  //
+  //   The output of include_cached statements, keyed by the included
+  //   file's name and hash, the publishing options, and the bound
+  //   arguments.  Bounded in total size (ok_pub3_frag_cache_size) and
+  //   per-entry size (ok_pub3_frag_cache_max_entry); entries expire
+  //   ok_pub3_frag_cache_ttl seconds after they're inserted, and the
+  //   oldest are evicted first.
+  //
+  class fragment_cache_t {
+  public:
+    fragment_cache_t () : _bytes (0), _hits (0), _misses (0) {}
+    ~fragment_cache_t () { clear (); }
+
+    // The pointer is only good until the next insert.
+    const vec<zstr> *lookup (const str &k);
+    void insert (const str &k, const vec<zstr> &v);
+    void clear ();
+
+    u_int64_t hits () const { return _hits; }
+    u_int64_t misses () const { return _misses; }
+    size_t bytes () const { return _bytes; }
+    size_t size () const { return _tab.size (); }
+
+  private:
+    struct entry_t {
+      entry_t (const str &k, const vec<zstr> &v, size_t b);
+      const str _key;
+      vec<zstr> _out;
+      size_t _bytes;
+      time_t _ctime;
+      ihash_entry<entry_t> _hlnk;
+      tailq_entry<entry_t> _qlnk;
+    };
+
+    void remove (entry_t *e);
+    void expire ();
+    void make_room (size_t b);
+
+    ihash<const str, entry_t, &entry_t::_key, &entry_t::_hlnk> _tab;
+    tailq<entry_t, &entry_t::_qlnk> _q;  // oldest first
+    size_t _bytes;
+    u_int64_t _hits, _misses;
+  };
+
+  //-----------------------------------------------------------------------
+
+  fragment_cache_t *get_fragment_cache ();
+
+  //-----------------------------------------------------------------------
+};
@@ -21,6 +21,10 @@ namespace pub3 {
     
     virtual bool might_block () const { return false; }
 
+    // Lambdas push frames onto the eval_t's environment, so two of them
+    // can't be in flight on the same eval_t at once.
+    virtual bool is_lambda () const { return false; }
+
     virtual ptr<const expr_t> eval_to_val (eval_t *e, args_t args) const = 0;
     virtual ptr<mref_t> eval_to_ref (eval_t *e, args_t args) const;
     virtual ptr<expr_t> eval_to_mval (eval_t *e, args_t args) const;
@@ -42,6 +46,7 @@ namespace pub3 {
     void set_name (str n) { _name = n; }
     str to_str (PUB3_TO_STR_ARG) const;
     bool might_block () const;
+    bool is_lambda () const { return true; }
 
     ptr<const expr_t> eval_to_val (eval_t *e, args_t args) const;
     ptr<const expr_t> eval_to_val (eval_t *e) const;
@@ -133,6 +138,13 @@ namespace pub3 {
 
     void unshift_argument (ptr<expr_t> x);
     ptr<call_t> coerce_to_call () { return mkref (this); }
+    ptr<const call_t> to_call () const { return mkref (this); }
+    ptr<const expr_t> fn () const { return _fn; }
+
+    // Look up the function to call, for a call whose function
+    // expression doesn't block; reports an error if there's none.
+    ptr<const callable_t> resolve (eval_t *p) const
+    { return eval_prepare (p); }
     void v_dump (dumper_t *d) const;
     void propogate_metadata (ptr<const metadata_t> md);
 
@@ -57,6 +57,17 @@ namespace pub3 {
 		      status_t *sp = NULL, 
 		      ptr<file_t> *fp = NULL, CLOSURE) = 0;
 
+    /**
+     * As above, but write the output through the given output_t,
+     * such as an output_stream_t that sends it to the client as
+     * it goes.
+     */
+    virtual void run_output (ptr<output_t> o, str fn, evb_t ev,
+			     ptr<expr_dict_t> d = NULL,
+			     opts_t opts = -1,
+			     status_t *sp = NULL,
+			     ptr<file_t> *fp = NULL, CLOSURE) = 0;
+
     /**
      * Run the publisher, ignoring output, just amassing all universals
      * and globals into the given dictionary.]
@@ -118,6 +129,10 @@ namespace pub3 {
 	      opts_t opts = 0, status_t *sp = NULL, ptr<file_t> *fp = NULL,
 	      CLOSURE);
 
+    void run_output (ptr<output_t> o, str fn, evb_t ev,
+		     ptr<expr_dict_t> d = NULL, opts_t opts = 0,
+		     status_t *sp = NULL, ptr<file_t> *fp = NULL, CLOSURE);
+
     void run_pub (eval_t *p, str fn, evb_t ev,
 		  status_t *sp = NULL, ptr<file_t> *fp = NULL,
 		  CLOSURE);
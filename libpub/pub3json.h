@@ -0,0 +1,144 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3expr.h"
+#include "zstr.h"
+#include "pub3symtab.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // JSON output
+  //
+  //   json_writer_t writes an expr_t tree as JSON in one pass: each
+  //   node's to_json () appends straight to one flat buffer, rather than
+  //   returning a str that its parent then glues into its own.  The
+  //   output is just what to_str () gives with quoting on.
+  //
+  //   The buffer is a scratch arena that writers hand down to each
+  //   other, so that, once it's grown to fit, serializing allocates
+  //   only the result.  Dict keys are mostly clean, and copied as they
+  //   are; those that aren't are escaped once per writer.
+  //
+  //-----------------------------------------------------------------------
+
+  class json_writer_t {
+  public:
+    json_writer_t (str_opt_t o = str_opt_t ());
+    ~json_writer_t ();
+
+    void write (ptr<const expr_t> x);     // NULL comes out as null
+    void write_str (const str &s);
+    void write_key (const str &k);        // k, quoted, and a colon
+    void write_int (int64_t i);
+    void write_uint (u_int64_t u);
+    void write_double (double d);
+    void write_sep ();
+    void write_raw (const char *p, size_t n);
+    void write_raw (const char *p) { write_raw (p, strlen (p)); }
+    void write_raw (const str &s) { if (s) write_raw (s.cstr (), s.len ()); }
+    void write_raw (char c) { *reserve (1) = c; _len++; }
+
+    str_opt_t opts () const { return _opts; }
+    size_t len () const { return _len; }
+    str to_str () const;
+    void output (zbuf *z) const;
+
+  private:
+    char *reserve (size_t n);  // room for n more bytes at _buf + _len
+
+    str_opt_t _opts;
+    char *_buf;
+    size_t _len, _cap;
+    bool _borrowed;            // whether _buf is the shared arena
+    qhash<str, str> _keys;
+  };
+
+  //-----------------------------------------------------------------------
+  //
+  // JSON input
+  //
+  //   json_fast_parser_t builds an expr_t tree straight from JSON text,
+  //   without going through flex and bison.  It takes the common subset
+  //   of what json_parser_t takes -- double-quoted strings, decimal
+  //   numbers that fit, and the usual escapes -- and gives up (returns
+  //   NULL) on anything else, including malformed input; callers then
+  //   go to json_parser_t, which has the last word on what's legal,
+  //   and reports the errors.  So the two never disagree on a result.
+  //
+  //   String bodies, which are most of the bytes in practice, are
+  //   scanned with an escape_kernel_t, so 16 or 32 bytes at a time
+  //   where there's SSE2 or AVX2.  Dict keys share symtab_t's copy
+  //   when a template names them, but aren't added to it; a list of
+  //   records shares its keys anyway, through one record_schema_t.
+  //
+  //   Input can be given in one piece to parse (), or in pieces, as it
+  //   comes off the network, to add (), and then finish ().  Only an
+  //   incomplete token is held over between pieces.
+  //
+  //-----------------------------------------------------------------------
+
+  class json_fast_parser_t {
+  public:
+    json_fast_parser_t ();
+    ~json_fast_parser_t ();
+
+    static ptr<expr_t> parse (const str &in);
+
+    // false once the parse has given up; more input is then ignored.
+    bool add (const char *p, size_t len);
+    bool add (const str &s) { return add (s.cstr (), s.len ()); }
+
+    // The result, or NULL if there's none; the parser is then reset.
+    ptr<expr_t> finish ();
+
+  private:
+    enum state_t { VALUE = 0,
+		   LIST_FIRST = 1,
+		   LIST_NEXT = 2,
+		   DICT_FIRST = 3,
+		   DICT_KEY = 4,
+		   DICT_COLON = 5,
+		   DICT_NEXT = 6,
+		   DONE = 7,
+		   FAILED = 8 };
+
+    enum { MAX_DEPTH = 0x400 };
+
+    struct frame_t {
+      ptr<expr_list_t> _list;
+      ptr<expr_dict_t> _dict;
+      str _key;
+    };
+
+    // The read_* () and *_frame () routines return 1 on success, 0 if
+    // they need more input, and -1 to give up.
+    size_t run (const char *p, size_t len, bool eof);
+    int read_value (const char *p, size_t len, size_t *ip, bool eof);
+    int read_str (const char *p, size_t len, size_t *ip, bool eof,
+		  bool key, str *out);
+    int read_num (const char *p, size_t len, size_t *ip, bool eof);
+    int read_lit (const char *p, size_t len, size_t *ip, bool eof,
+		  const char *lit, ptr<expr_t> x);
+    int open_frame (ptr<expr_list_t> l, ptr<expr_dict_t> d, state_t s);
+    int close_frame ();
+    int push_value (ptr<expr_t> x);
+    void hold (const char *p, size_t len);
+    void reset ();
+
+    state_t _state;
+    vec<frame_t> _stack;
+    ptr<expr_t> _out;
+
+    size_t _resume;            // how far into a split string we've scanned
+    bool _resume_esc;          // and whether we saw escapes there
+
+    char *_buf;                // input held over between add ()s
+    size_t _len, _cap;
+  };
+
+  //-----------------------------------------------------------------------
+};
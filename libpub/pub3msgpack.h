@@ -15,8 +15,67 @@ namespace pub3 {
     // errno on failure and the len of the read
     ptr<pub3::expr_t> decode (str m, int *err = NULL, size_t *len = NULL);
 
+    // As above, but only the outermost list or map is decoded; the
+    // lists and maps in it are view_t's, decoded when they're used.
+    ptr<pub3::expr_t> decode_lazy (str m, int *err = NULL,
+				   size_t *len = NULL);
+
     str encode (ptr<const pub3::expr_t> x);
 
+    //========================================
+
+    //
+    // A list or map still in its msgpack encoding, at [start, end) in
+    // buf.  decode_lazy () checks that the whole message is well
+    // formed, but builds just the top level of it; each list or map
+    // below that becomes a view_t, which holds on to the message, and
+    // decodes itself -- one more level, with its own lists and maps
+    // as views -- the first time it's used as anything but a whole.
+    // So a page that reads a few fields of a big response builds just
+    // the objects on the way to those fields, and copies just those
+    // strings.  Passing a view on whole (say, to encode () it again
+    // for another RPC) doesn't decode it at all.
+    //
+    // Once decoded, a view defers to what it decoded, so changes
+    // made through it stick, as with any list or dict.
+    //
+    class view_t : public pub3::expr_t {
+    public:
+      view_t (str buf, size_t start, size_t end);
+
+      ptr<pub3::expr_dict_t> to_dict ();
+      ptr<const pub3::expr_dict_t> to_dict () const;
+      ptr<pub3::expr_list_t> to_list ();
+      ptr<const pub3::expr_list_t> to_list () const;
+      ptr<const pub3::expr_record_t> to_record () const;
+
+      bool to_len (size_t *s) const;
+      bool to_bool () const;
+      bool is_null () const;
+      str type_to_str () const;
+      bool is_static () const { return true; }
+      scalar_obj_t to_scalar () const;
+      str to_str (PUB3_TO_STR_ARG) const;
+      void to_json (pub3::json_writer_t *w) const;
+      bool to_xdr (xpub3_expr_t *x) const;
+      bool to_xdr (xpub3_json_t *x) const;
+      bool to_msgpack (outbuf_t *x) const;
+      void v_dump (dumper_t *d) const;
+      const char *get_obj_name () const { return "pub3::msgpack::view_t"; }
+
+      ptr<pub3::expr_t> deep_copy () const;
+      ptr<pub3::expr_t> cow_copy () const;
+
+    private:
+      bool is_map () const;
+      size_t size () const;
+      ptr<pub3::expr_t> val () const;   // decoded on first call
+
+      const str _buf;
+      const size_t _start, _end;
+      mutable ptr<pub3::expr_t> _x;
+    };
+
     //========================================
     
     class outbuf_t {
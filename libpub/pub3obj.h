@@ -6,6 +6,8 @@
 #include "pub3expr.h"
 #include "okformat.h"
 
+class zbuf;  // declared in zstr.h
+
 #define ALL_INT_TYPES(pre,x,post)   \
   pre (int64_t x) post              \
   pre (int32_t x) post              \
@@ -142,6 +144,7 @@ namespace pub3 {
     ptr<vec<str> > keys () const;
 
     str to_str () const;
+    void output_json (zbuf *z, str_opt_t o = str_opt_t ()) const;
     bool to_bool () const;
     int64_t to_int () const;
     u_int64_t to_uint () const;
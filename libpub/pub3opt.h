@@ -0,0 +1,36 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3ast.h"
+#include "pub3out.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // A pass over a freshly-loaded file that does the work which doesn't
+  // depend on the request: constant expressions are folded, if/elif
+  // clauses with constant conditions are pruned, and runs of static
+  // text are merged into one zone_text_t (and hence one zstr).
+  //
+  // Constant expressions are evaluated with a scratch eval_t; if that
+  // reports any error or warning, the expression is left alone, so that
+  // the runtime report still happens where it used to.
+  //
+  class optimizer_t {
+  public:
+    optimizer_t (ptr<const metadata_t> md);
+    static void run (ptr<zone_t> z, ptr<const metadata_t> md);
+
+    ptr<expr_t> fold (ptr<expr_t> x);
+    void merge_text (vec<ptr<zone_t> > *zones);
+    static bool is_scalar_constant (ptr<const expr_t> x);
+  private:
+    ptr<output_t> _out;
+    ptr<eval_t> _eval;
+  };
+
+  //-----------------------------------------------------------------------
+};
@@ -34,9 +34,25 @@ namespace pub3 {
     bool get_wss_enabled () const;
     opts_t get_opts () const;
     void set_opts (opts_t o);
+    size_t n_errors () const { return _n_errors; }
+    bool do_wss () const;
+
+    // Also copy whatever's output into v, until reset; returns the
+    // previous recorder.
+    vec<zstr> *set_recorder (vec<zstr> *v);
+    virtual bool can_record () const { return false; }
     
+    // Push what's been output so far to the client, if we can.
+    virtual void flush () {}
+
+    // An output that's paced makes the publisher take the async path
+    // through every node, and check backed_up () before each one; if
+    // it's true, the publisher waits on wait_for_room () before going on.
+    virtual bool paced () const { return false; }
+    virtual bool backed_up () const { return false; }
+    virtual void wait_for_room (evv_t ev) { ev->trigger (); }
+
   protected:
-    bool do_wss () const;
     void output_visible_error (str s);
     opts_t _opts;
     pub3::obj_list_t _err_obj;
@@ -44,6 +60,8 @@ namespace pub3 {
 
     bool _wss_enabled;
     str _wss_boundary;
+    size_t _n_errors;
+    vec<zstr> *_recorder;
   };
 
   //-----------------------------------------------------------------------
@@ -53,12 +71,49 @@ namespace pub3 {
     output_std_t (zbuf *z, opts_t o = 0) : output_t (o), _out (z) {}
     void output (zstr s);
     void output (str s);
-  private:
+    bool can_record () const { return !_muzzle; }
+  protected:
     zbuf *_out;
   };
 
   //-----------------------------------------------------------------------
 
+  //
+  // Output to a zbuf that's drained to the client as we go: the flush
+  // callback is called whenever more than hiwat bytes are buffered,
+  // and whenever the template calls flush().  It's expected to clear
+  // the zbuf.  A hiwat of 0 means only flush when asked to.  The
+  // publisher pauses between nodes while backed_up says the client is
+  // behind, until wait_for_room fires its event.
+  //
+  class output_stream_t : public output_std_t {
+  public:
+    typedef callback<bool>::ref backed_up_cb_t;
+    typedef callback<void, evv_t>::ref wait_cb_t;
+
+    output_stream_t (zbuf *z, opts_t o, size_t hiwat, cbv cb,
+		     backed_up_cb_t bu, wait_cb_t w)
+      : output_std_t (z, o), _hiwat (hiwat), _pending (0), _flush_cb (cb),
+	_backed_up_cb (bu), _wait_cb (w) {}
+    static ptr<output_stream_t> alloc (zbuf *z, opts_t o, size_t hiwat,
+				       cbv cb, backed_up_cb_t bu, wait_cb_t w);
+    void output (zstr s);
+    void output (str s);
+    void flush ();
+    bool paced () const { return true; }
+    bool backed_up () const { return (*_backed_up_cb) (); }
+    void wait_for_room (evv_t ev) { (*_wait_cb) (ev); }
+  private:
+    void check_hiwat (size_t n);
+    size_t _hiwat;
+    size_t _pending;
+    cbv _flush_cb;
+    backed_up_cb_t _backed_up_cb;
+    wait_cb_t _wait_cb;
+  };
+
+  //-----------------------------------------------------------------------
+
   class output_silent_t : public output_t {
   public:
     output_silent_t (opts_t o = 0) : output_t (o) {}
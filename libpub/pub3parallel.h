@@ -0,0 +1,91 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3expr.h"
+#include "pub3eval.h"
+
+namespace pub3 {
+
+  class statement_t;  // declared in pub3ast.h
+
+  //-----------------------------------------------------------------------
+  //
+  // Parallel evaluation of independent blocking calls
+  //
+  //   With ok_pub3_parallel on, a run of consecutive bindings in a
+  //   locals/globals block, or of consecutive assignment statements,
+  //   such as
+  //
+  //       x = get_user (* uid *);
+  //       y = get_ratings (* tid *);
+  //
+  //   has all its calls issued at once; the results are then bound in
+  //   order, once the last has come back.  A run qualifies if each
+  //   right-hand side is a blocking call whose function and arguments
+  //   don't block, whose arguments only read plain variables, and
+  //   that doesn't read any name bound earlier in the run.
+  //
+  //   Lambdas push frames onto the shared eval_t, so at run time, a
+  //   call that turns out to be to a lambda, or whose arguments hold
+  //   anything but plain data, still goes by itself, in order.
+  //
+  //-----------------------------------------------------------------------
+
+  class par_group_t {
+  public:
+    par_group_t () {}
+
+    // Add the call x, bound to name; false if it can't join the group.
+    bool add (str name, ptr<const expr_t> x);
+    size_t size () const { return _items.size (); }
+
+    // Evaluate all calls in the group, leaving their results in out,
+    // in order.
+    void pub (eval_t *p, vec<ptr<expr_t> > *out, evv_t ev, CLOSURE) const;
+
+  private:
+    struct item_t {
+      str _name;
+      ptr<const expr_t> _call;
+      vec<str> _arg_vars;
+    };
+    bool can_overlap (eval_t *p, const item_t &i,
+		      ptr<const callable_t> f) const;
+    void pub_batch (eval_t *p, const vec<size_t> *batch,
+		    const vec<ptr<const callable_t> > *fns,
+		    vec<ptr<expr_t> > *out, evv_t ev, CLOSURE) const;
+    void pub_one (eval_t *p, size_t j, ptr<const callable_t> f,
+		  ptr<expr_t> *out, evv_t ev, CLOSURE) const;
+
+    vec<item_t> _items;
+    bhash<str> _names;
+  };
+
+  //-----------------------------------------------------------------------
+
+  //
+  // A statement list's or decl block's handle on its groups, found the
+  // first time it's published, if ok_pub3_parallel is on.
+  //
+  class par_plan_t {
+  public:
+    par_plan_t () : _tried (false) {}
+
+    // The group that starts at position i, if there is one.
+    ptr<const par_group_t> at (const vec<ptr<statement_t> > &v,
+			       size_t i) const;
+    ptr<const par_group_t> at (const bindlist_t &v, size_t i) const;
+
+  private:
+    void plan (const vec<str> &names,
+	       const vec<ptr<const expr_t> > &rhs) const;
+    ptr<const par_group_t> lookup (size_t i) const;
+
+    mutable vec<ptr<const par_group_t> > _groups;
+    mutable bool _tried;
+  };
+
+  //-----------------------------------------------------------------------
+};
@@ -0,0 +1,100 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3prot.h"
+#include "pub3file.h"
+#include "qhash.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // Precompiled pub3 files
+  //
+  //   With ok_pub3_precompiled_dir set, pubd writes each file it serves
+  //   into that directory, once, as its XDR image (which has no
+  //   pointers, and so can be mapped anywhere), behind a small header:
+  //
+  //       "P3PC" | version | datasize | sha1 (image)
+  //
+  //   where the integers are in network byte order.  The file is named
+  //   by the image's hash, so a changed template gets a new file, and an
+  //   old one is never rewritten under a service that's reading it.
+  //
+  //   The disk work is done by one helper process that pubd forks when
+  //   it starts, so pubd's event loop never waits on it.  The first
+  //   request for an image queues it to the helper, and is served as
+  //   usual.  Once the helper says it's done, pubd hands services the
+  //   name in place of the file; the service maps the file read-only,
+  //   shared with all the other services reading it, checks the header
+  //   against what pubd said, and decodes the image straight from the
+  //   mapping.  If anything is off, it fetches the chunks from pubd as
+  //   before.  Services still decode into their own trees; what's
+  //   shared is the page cache for the image, and the transfer from
+  //   pubd is skipped.
+  //
+  //   Every ok_pub3_precompiled_clean_interval seconds, pubd forgets
+  //   the images no one's asked for in ok_pub3_precompiled_lifetime
+  //   seconds, and has the helper remove them.
+  //
+  //   The version is bumped whenever pub3prot.x changes the XDR of
+  //   xpub3_file_t.
+  //
+  //-----------------------------------------------------------------------
+
+  enum { PRECOMPILED_VERSION = 1 };
+
+  struct precompiled_image_t;  // see pub3precompiled.C
+
+  class precompiled_t {
+  public:
+
+    // pubd side: the name of f's image in the precompiled directory,
+    // or NULL if there's no directory, or the image isn't there yet (in
+    // which case it's written in the background).
+    // f->init_xdr_opaque () must have been called.
+    static str write (ptr<const file_t> f);
+
+    // pubd side: start the writer helper, and remove unused images
+    // periodically; call once pubd is in its jail.
+    static void start ();
+
+    // Service side: decode the file that pubd named in pc; false, with
+    // the reason in *err, if it couldn't be done.
+    static bool read (const xpub3_precompiled_t &pc, xpub3_file_t *file,
+		      str *err);
+
+  private:
+    struct hdr_t {
+      char _magic[4];
+      u_int32_t _version;
+      u_int32_t _datasize;
+      char _xdrhash[PUBHASHSIZE];
+    };
+    typedef precompiled_image_t image_t;
+
+    static bool check (const char *p, size_t len,
+		       const xpub3_chunkshdr_t &ch, str *err);
+    static bool write_file (str nm, const xpub3_hash_t &xh, 
+			    const char *dat, size_t len);
+    static void clean_loop ();
+    static void clean ();
+    static bool clean_dir (bhash<str> *keep);
+
+    // pubd's end of the writer helper
+    static bool start_writer ();
+    static bool writer_send (const xpub3_pcw_arg_t &a);
+    static void writer_output ();
+    static void writer_input ();
+    static void writer_reply (const xpub3_pcw_res_t &r);
+    static void writer_died (pid_t pid, int status);
+    static void writer_fail ();
+
+    // the helper itself
+    static void writer_main (int fd);
+  };
+
+  //-----------------------------------------------------------------------
+};
@@ -453,7 +453,8 @@ enum xpub3_statement_typ_t {
    XPUB3_STATEMENT_CONTINUE = 14,
    XPUB3_STATEMENT_GLOBALS = 15,
    XPUB3_STATEMENT_WHILE = 16,
-   XPUB3_STATEMENT_EXIT = 17
+   XPUB3_STATEMENT_EXIT = 17,
+   XPUB3_STATEMENT_INCLUDE_CACHED = 18
 };
 
 %struct xpub3_zone_t;
@@ -464,6 +465,7 @@ union xpub3_statement_t switch (xpub3_statement_typ_t typ) {
 
  case XPUB3_STATEMENT_INCLUDE:
  case XPUB3_STATEMENT_LOAD:
+ case XPUB3_STATEMENT_INCLUDE_CACHED:
    xpub3_include_t include;
 
  case XPUB3_STATEMENT_ZONE:
@@ -615,7 +617,8 @@ enum xpub_status_typ_t {
 
 enum xpub3_xfer_mode_t {
   XPUB_XFER_WHOLE = 0,
-  XPUB_XFER_CHUNKED = 1
+  XPUB_XFER_CHUNKED = 1,
+  XPUB_XFER_PRECOMPILED = 2
 };
 
 typedef string xpub3_errstr_t<>;
@@ -657,11 +660,48 @@ struct xpub3_chunkshdr_t {
   xpub3_hash_t          dathash;   /* hash of the file's data */
 };
 
+struct xpub3_precompiled_t {
+  string                name<>;    /* file in the precompiled dir */
+  xpub3_chunkshdr_t     chunks;    /* to get it as chunks, if that fails */
+};
+
 union xpub3_xfered_file_t switch (xpub3_xfer_mode_t mode) {
 case XPUB_XFER_WHOLE:
   xpub3_file_t whole;
 case XPUB_XFER_CHUNKED:
   xpub3_chunkshdr_t chunked;  
+case XPUB_XFER_PRECOMPILED:
+  xpub3_precompiled_t precompiled;
+};
+
+/*
+ * Between pubd and the helper process that writes its precompiled
+ * images; see pub3precompiled.h.
+ */
+enum xpub3_pcw_op_t {
+  XPUB3_PCW_WRITE = 0,
+  XPUB3_PCW_CLEAN = 1
+};
+
+typedef string xpub3_pcw_name_t<>;
+
+struct xpub3_pcw_write_t {
+  xpub3_pcw_name_t      name;
+  xpub3_hash_t          xdrhash;
+  opaque                image<>;   /* the XDR of the xpub3_file_t */
+};
+
+union xpub3_pcw_arg_t switch (xpub3_pcw_op_t op) {
+case XPUB3_PCW_WRITE:
+  xpub3_pcw_write_t     write;
+case XPUB3_PCW_CLEAN:
+  xpub3_pcw_name_t      keep<>;    /* images still in use */
+};
+
+struct xpub3_pcw_res_t {
+  xpub3_pcw_op_t        op;
+  xpub3_pcw_name_t      name;
+  bool                  ok;
 };
 
 enum xpub3_freshness_typ_t {
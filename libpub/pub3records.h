@@ -0,0 +1,148 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "pub3expr.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // Record lists
+  //
+  //   Backends hand us result sets as long lists of dicts that all
+  //   have the same keys.  Decoded one by one, each row costs a
+  //   bindtab_t, a slot per field, and the values.  So the XDR and
+  //   msgpack decoders pass long lists through a record_builder_t
+  //   instead, which keeps one record_schema_t -- the keys, and which
+  //   column each is in -- for the whole list, and the values of all
+  //   of the rows in one flat array, a record_set_t.  The list is then
+  //   a plain expr_list_t of expr_record_t's, each a small view onto
+  //   one row of that array.
+  //
+  //   To templates and library functions, a record is a dict: its
+  //   type is "dict", and to_dict () gives one.  Field lookups (x.k
+  //   and x["k"]), len (), and JSON output are answered from the
+  //   columns; anything else builds a real dict, once, which the
+  //   record keeps and defers to from then on, so that changes made
+  //   through it stick.  Copies are copies of that dict, as usual.
+  //
+  //   A row whose keys aren't the first row's, or whose values aren't
+  //   all static, is made a plain dict, as is every row of a list
+  //   shorter than ok_pub3_record_list_min.
+  //
+  //-----------------------------------------------------------------------
+
+  class record_schema_t : public virtual refcount {
+  public:
+    record_schema_t () {}
+    size_t width () const { return _keys.size (); }
+    const str &key (size_t i) const { return _keys[i]; }
+
+    // false if k is already a column
+    bool add (const str &k);
+    bool column (const str &k, size_t *ip) const;
+
+    // The columns in the order that a dict of the same keys lists
+    // them, so that a record prints just as a dict would.
+    const vec<size_t> &order () const;
+
+  private:
+    vec<str> _keys;
+    qhash<str, size_t> _cols;
+    mutable vec<size_t> _order;
+  };
+
+  //-----------------------------------------------------------------------
+
+  class record_set_t : public virtual refcount {
+  public:
+    record_set_t (ptr<const record_schema_t> s, size_t nrows);
+    const record_schema_t &schema () const { return *_schema; }
+    size_t nrows () const { return _nrows; }
+
+    ptr<expr_t> cell (size_t row, size_t col) const
+    { return _cells[row * _schema->width () + col]; }
+
+    // Room for one more row, all NULL; pop_row () takes it back.
+    ptr<expr_t> *add_row ();
+    void pop_row ();
+
+  private:
+    const ptr<const record_schema_t> _schema;
+    vec<ptr<expr_t> > _cells;
+    size_t _nrows;
+  };
+
+  //-----------------------------------------------------------------------
+
+  class expr_record_t : public expr_t {
+  public:
+    expr_record_t (ptr<const record_set_t> s, size_t row, lineno_t l)
+      : expr_t (l), _set (s), _row (row) {}
+
+    // k's value, or NULL if there's no such field.
+    ptr<const expr_t> lookup (const str &k) const;
+
+    ptr<const expr_record_t> to_record () const { return mkref (this); }
+    ptr<expr_dict_t> to_dict ();
+    ptr<const expr_dict_t> to_dict () const;
+
+    bool to_len (size_t *s) const;
+    bool to_bool () const;
+    str type_to_str () const { return "dict"; }
+    bool is_static () const { return true; }
+    scalar_obj_t to_scalar () const;
+    str to_str (PUB3_TO_STR_ARG) const;
+    void to_json (json_writer_t *w) const;
+    bool to_xdr (xpub3_expr_t *x) const;
+    bool to_xdr (xpub3_json_t *x) const;
+    bool to_msgpack (msgpack::outbuf_t *x) const;
+    void v_dump (dumper_t *d) const;
+    const char *get_obj_name () const { return "pub3::expr_record_t"; }
+
+    ptr<expr_t> deep_copy () const;
+    ptr<expr_t> cow_copy () const;
+
+  private:
+    ptr<expr_dict_t> make_dict (bool copy_vals) const;
+    ptr<const expr_dict_t> view () const;   // _dict, or a throwaway
+    ptr<expr_dict_t> dict () const;         // _dict, made if need be
+
+    const ptr<const record_set_t> _set;
+    const size_t _row;
+    mutable ptr<expr_dict_t> _dict;
+  };
+
+  //-----------------------------------------------------------------------
+
+  class record_builder_t {
+  public:
+    // n is the length of the list being decoded.  It may come from the
+    // input, so no more than max rows are allowed for ahead of time.
+    record_builder_t (size_t n, size_t max = size_t (-1));
+
+    // Whether rows might still become records; if not, the caller may
+    // as well decode the rest as it would have anyway.
+    bool on () const { return _on; }
+
+    // Give the fields of one row with add (), then take the row from
+    // end_row (), as a record if it fits, or else as a dict.
+    void add (const str &k, ptr<expr_t> v);
+    ptr<expr_t> end_row (lineno_t l = -1);
+
+  private:
+    bool start ();
+    ptr<expr_t> add_record (lineno_t l);
+    ptr<expr_t> add_dict ();
+
+    bool _on;
+    ptr<record_set_t> _set;
+    size_t _nrows;
+    vec<str> _keys;
+    vec<ptr<expr_t> > _vals;
+  };
+
+  //-----------------------------------------------------------------------
+};
@@ -0,0 +1,73 @@
+// -*-c++-*-
+/* $Id$ */
+
+#pragma once
+
+#include "async.h"
+
+namespace pub3 {
+
+  //-----------------------------------------------------------------------
+  //
+  // Interned symbols
+  //
+  //   symtab_t is one process-wide table of the short strings that name
+  //   things in pub3 templates -- identifiers, and dict keys -- as the
+  //   parser and the XDR decoder of parsed files find them.  Interning
+  //   gives back the table's copy of a string, so that a name used in
+  //   many places is stored once, and two interned names can be compared
+  //   by pointer; sym_eq () tries that before it compares bytes.
+  //
+  //   Keys from request data -- JSON bodies, msgpack, JSON over XDR --
+  //   go through lookup () instead, which shares the table's copy if a
+  //   template has named the key, but never adds to the table; the
+  //   table isn't evicted from, so anyone sending keys could otherwise
+  //   fill it.
+  //
+  //   Long strings aren't interned, and once the table is full, new
+  //   strings are passed through as they are; both still compare right
+  //   with sym_eq (), just not as fast.
+  //
+  //-----------------------------------------------------------------------
+
+  class symtab_t {
+  public:
+    static str intern (const char *p, size_t len);
+    static str intern (const char *p) { return intern (p, strlen (p)); }
+    static str intern (const str &s);
+
+    // As intern (), but if the string isn't in the table already, it's
+    // returned as is (or copied), and not added.
+    static str lookup (const char *p, size_t len);
+    static str lookup (const str &s);
+    static size_t size () { return _n; }
+
+    enum { MAX_SYM_LEN = 0x40,
+	   MIN_SIZE = 0x100,
+	   MAX_SIZE = 0x8000 };
+
+  private:
+    struct slot_t {
+      slot_t () : _hash (0) {}
+      u_int32_t _hash;
+      str _sym;
+    };
+
+    static const str *find (const char *p, size_t len, u_int32_t h,
+			    size_t *ip);
+    static bool grow (size_t *ip, u_int32_t h);
+
+    static slot_t *_tab;
+    static size_t _size, _n;
+  };
+
+  //-----------------------------------------------------------------------
+
+  inline bool
+  sym_eq (const str &a, const str &b)
+  {
+    return a.cstr () == b.cstr () || a == b;
+  }
+
+  //-----------------------------------------------------------------------
+};
@@ -6,6 +6,7 @@
 #include "pub_parse.h"
 #include "parse.h"
 #include "pub3parse.h"
+#include "pub3symtab.h"
 #include "qhash.h"
 #include <wchar.h>
 #include <locale.h>
@@ -568,6 +569,7 @@ public:
     _tab.insert ("else", T_P3_ELSE);
     _tab.insert ("empty", T_P3_EMPTY);
     _tab.insert ("load", T_P3_LOAD);
+    _tab.insert ("include_cached", T_P3_INCLUDE_CACHED);
     _tab.insert ("print", T_P3_PRINT);
     _tab.insert ("case", T_P3_CASE);
     _tab.insert ("switch", T_P3_SWITCH);
@@ -604,7 +606,7 @@ p3_identifier (const char *yyt)
 {
    int ret;
    if (!p3_id_tab.lookup (yyt, &ret)) {
-     yylval.str = yyt;
+     yylval.str = pub3::symtab_t::intern (yyt);
      ret = T_P3_IDENTIFIER;
    }
    return ret;
@@ -39,7 +39,7 @@
 class ztab;
 class zstrobj {
 public:
-  zstrobj (const str &ss) : s (ss) {}
+  zstrobj (const str &ss) : s (ss), clev (Z_DISABLE) {}
   zstrobj (const str &ss, const str &zz, int l) : s (ss), zs (zz), clev (l) {}
   size_t len () const { return s ? s.len () : 0; }
   const char *dat () const { return s ? s.cstr () : NULL; }
@@ -154,6 +154,18 @@ public:
 
 };
 
+//
+// Running state for a gzip stream that goes out in several pieces;
+// see zbuf::stream_part.
+//
+struct zstream_state_t {
+  zstream_state_t () : started (false), crc (::crc32 (0L, Z_NULL, 0)),
+		       ilen (0) {}
+  bool started;
+  uLong crc;
+  uLong ilen;
+};
+
 class zbuf : public compressible_t {
 public:
   zbuf () : endbuf (ZSTR_ENDBUF_SIZE), minstrsize (ok_gzip_smallstr) {} 
@@ -192,7 +204,15 @@ public:
 
   int output (int fd, compressible_t::opts_t o = opts_t ());
   void to_zstr_vec (vec<zstr> *zs);
+
+  // Move what's been buffered so far onto the end of b, as the next
+  // piece of a streamed body, and clear the buffer.  With o.chunked,
+  // the piece is framed as one HTTP chunk, and the last piece is
+  // followed by the terminating chunk.
+  int stream_part (strbuf *b, compressible_t::opts_t o, zstream_state_t *st,
+		   bool last);
 private:
+  bool compress_part (strbuf *b, int lev, zstream_state_t *st, bool last);
 
   inline void push_zstr (const zstr &z, bool clr = true);
   inline void push_str (const str &s, bool clr = true);
@@ -334,6 +354,10 @@ zbuf::cat (const zstr &z, bool cp)
 {
   if (z.len () <= minstrsize) { 
     strbuf_add (z, cp);
+  } else if (z.compressed ()) {
+    // already deflated (e.g., a static pub3 zone); keep this copy
+    // rather than hashing it to find a cached one.
+    push_zstr (z);
   } else { 
     zstr *zp = get_ztab ()->lookup (z);
     if (zp) {
@@ -67,6 +67,7 @@ namespace rfn3 {
   PUB3_COMPILED_FN_DOC(logwarn, "s|b");
   PUB3_COMPILED_FN_DOC(warn_trace, "s");
   PUB3_COMPILED_FN_DOC(enable_wss, "b");
+  PUB3_COMPILED_FN_DOC(flush, "");
   PUB3_COMPILED_FN_DOC(internal_dump, "O");
   PUB3_COMPILED_FN_DOC(unbind, "s|s");
   PUB3_COMPILED_FN_DOC(copy, "O");
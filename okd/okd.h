@@ -51,20 +51,58 @@ typedef enum { OKD_JAILED_NEVER = 0,
 typedef enum { OKD_CHLDMODE_SOURCE_HASH = 0,
                OKD_CHLDMODE_RR = 1,
                OKD_CHLDMODE_SOURCE_HASH_HEADER = 2,
-               OKD_CHLDMODE_LAST = 3 } okd_chldmode_t;
+               OKD_CHLDMODE_LEAST_LOADED = 3,
+               OKD_CHLDMODE_CONSISTENT_HASH = 4,
+               OKD_CHLDMODE_LAST = 5 } okd_chldmode_t;
 
 class okch_t;
 typedef callback<void, okch_t *>::ref cb_okch_t;
 
 //=======================================================================
 
+struct okd_key_share_t {
+  okd_key_share_t () : _brother_id (0), _n_keyed (0), _n_rekeyed (0) {}
+  str _servpath;
+  size_t _brother_id;
+  size_t _n_keyed;    // connections whose key hashed to this brother
+  size_t _n_rekeyed;  // connections failed over to this brother
+};
+
+struct okd_recycler_stat_t {
+  okd_recycler_stat_t () : _hits (0), _misses (0) {}
+  str _name;
+  u_int64_t _hits;    // allocations served from the free list
+  u_int64_t _misses;  // allocations that fell through to new
+};
+
+struct okd_cache_stat_t {
+  okd_cache_stat_t () : _hits (0), _misses (0), _entries (0), _bytes (0) {}
+  str _name;
+  u_int64_t _hits;
+  u_int64_t _misses;
+  u_int64_t _entries;
+  u_int64_t _bytes;
+};
+
 struct okd_stats_t {
+  okd_stats_t ()
+    : _uptime (0), _n_req (0), _n_recv (0), _n_sent (0), _n_tot (0),
+      _n_workers (0) {}
   void to_strbuf (strbuf &b) const;
+  void add_recycler (const okctl_recycler_stat_t &r);
+  void add_cache (const okctl_cache_stat_t &c);
+  void add_worker (const okd_worker_stats_t &w);
   time_t _uptime;
   size_t _n_req;
   size_t _n_recv;
   size_t _n_sent;
   size_t _n_tot;
+  size_t _n_workers;               // okd accept workers reporting
+  vec<okd_key_share_t> _key_shares;
+  buf_pool_stats_t _okd_buf_pool;  // summed over all okd workers
+  buf_pool_stats_t _svc_buf_pool;  // summed over all services
+  vec<okd_recycler_stat_t> _recyclers; // by name, over all services
+  vec<okd_cache_stat_t> _caches;       // by name, over all services
 };
 
 //=======================================================================
@@ -109,7 +147,7 @@ public:
   void launch ();
   void clone (ahttpcon_wrapper_t<ahttpcon_clone> acw, CLOSURE);
   void send_con_to_service (ahttpcon_wrapper_t<ahttpcon_clone> acw, 
-			    evv_t ev, CLOSURE);
+			    evv_t ev);
   void shutdown (oksig_t sig, evv_t ev, CLOSURE);
 
   void got_new_ctlx_fd (int fd, int p);
@@ -151,6 +189,16 @@ public:
   } status_t;
 
   status_t get_status () const;
+
+  // Number of connections handed to this child that it hasn't yet
+  // ACKed; used for load-based child selection.
+  int load () const { return _per_svc_nfd_in_xit; }
+  time_t oldest_dispatch () const { return _dispatch_times.oldest (); }
+
+  // Accounting for consistent-hash child selection.
+  void inc_n_keyed (bool primary) { if (primary) _n_keyed++; else _n_rekeyed++; }
+  void to_key_share (okd_key_share_x_t *out) const;
+
   void send_msg (str m, evs_t ev, CLOSURE);
   
   okd_t *_myokd;
@@ -161,8 +209,25 @@ public:
 protected:
   void handle_reenable_accept (svccb *sbp);
   void start_chld ();
+
+  void send_one_con (ahttpcon_wrapper_t<ahttpcon_clone> acw, evv_t ev, 
+		     CLOSURE);
+  void enqueue_con (ahttpcon_wrapper_t<ahttpcon_clone> acw, evv_t ev);
+  void flush_batch (ptr<bool> df);
+  void send_con_batch (CLOSURE);
+  void handle_sendcon_res (okctl_sendcon_res_t res, ptr<bool> df);
+  void abort_batch ();
 private:
 
+  // A connection waiting to go out in the next OKCTL_SEND_CON_BATCH
+  struct pending_con_t {
+    pending_con_t () {}
+    pending_con_t (ahttpcon_wrapper_t<ahttpcon_clone> a, evv_t e)
+      : _acw (a), _ev (e) {}
+    ahttpcon_wrapper_t<ahttpcon_clone> _acw;
+    evv_t::ptr _ev;
+  };
+
   okc_state_t _state;
   ptr<bool> _destroyed;
   bool _srv_disabled;
@@ -179,6 +244,12 @@ private:
   evv_t::ptr _ready_trigger; 
 
   time_list_t _dispatch_times;
+
+  size_t _n_keyed;          // N keys hashed here (consistent hash mode)
+  size_t _n_rekeyed;        // N keys failed over to here
+
+  vec<pending_con_t> _batch;
+  bool _batch_flush_pending;
 };
 
 //=======================================================================
@@ -196,6 +267,10 @@ public:
   const okch_t *child (size_t i) const { return _children[i]; }
   okch_t *find_best_fit_child (ref<ahttpcon_clone> xc, okch_t::status_t *sp,
 			       int pref = -1, ptr<ahttp_delimit_res> dres = nullptr);
+  size_t find_least_loaded_child () const;
+  u_int64_t source_key (ref<ahttpcon_clone> xc, 
+                        ptr<ahttp_delimit_res> dres) const;
+  okch_t *find_consistent_child (u_int64_t key, okch_t::status_t *sp);
   void killed (size_t i, okch_t *ch);
 
   void set_states (okc_state_t st);
@@ -254,7 +329,7 @@ class okd_t : public ok_httpsrv_t, public config_parser_t
 {
 public:
   okd_t (const str &cf, int logfd_in, int okldfd_in, const str &cdd, 
-	 okws1_port_t p, int pub2fd_in) : 
+	 okws1_port_t p, int pub2fd_in, size_t wid = 0) : 
     ok_httpsrv_t (NULL, logfd_in, pub2fd_in),
     config_parser_t (),
     okd_usr (ok_okd_uname), okd_grp (ok_okd_gname),
@@ -278,7 +353,8 @@ public:
     _emerg_kill_wait (okd_emergency_kill_wait_time),
     _emerg_kill_signal (okd_emergency_kill_signal),
     _child_mode(OKD_CHLDMODE_SOURCE_HASH),
-    _okd_all_headers(false)
+    _okd_all_headers(false),
+    _worker_id (wid)
   {
     listenport = p;
   }
@@ -320,6 +396,12 @@ public:
   void emerg_kill (oksvc_descriptor_t d, evv_t::ptr ev = NULL, CLOSURE);
   bool need_okld_rpc () const;
 
+  // With OkdAcceptWorkers > 1, okld runs several okds that share the
+  // listen ports.  Worker 0 is the primary: it alone owns the
+  // management socket and the SSL channels.
+  size_t worker_id () const { return _worker_id; }
+  bool is_primary () const { return _worker_id == 0; }
+
   servtab_t servtab;
   qhash<str, str> aliases;
 
@@ -371,6 +453,8 @@ protected:
 
   /* statistics */
   void stats_collect (okd_stats_t *s, evv_t ev, CLOSURE);
+  void to_worker_stats (okd_worker_stats_t *out);
+  void get_worker_stats (svccb *sbp);
   void render_stats_page (ptr<ahttpcon_clone> x, evv_t ev, CLOSURE);
   void send_stats_reply (ptr<ahttpcon> x, const okd_stats_t &stats, htpv_t v,
 			 evv_t ev, CLOSURE);
@@ -430,6 +514,7 @@ private:
   int _emerg_kill_signal;
   okd_chldmode_t _child_mode;
   bool _okd_all_headers;
+  const size_t _worker_id;
 
   vec<okws1_port_t> _ssl_ports;
 };
@@ -78,6 +78,10 @@ public:
   void activate ();
   bool active () const { return _active; }
 
+  // A fresh, unlaunched helper with the same exec, env, user, group
+  // and dump directory; used to run several okds from one OkdExecPath.
+  ptr<okld_helper_t> clone () const;
+
 protected:
   bool configure_user ();
   bool configure_group ();
@@ -357,7 +361,7 @@ public:
 
   okld_t *okld ();
   void add_direct_port (int p);
-  void post_spawn (int fd, evb_t ev, CLOSURE);
+  void post_spawn (int fd, vec<int> wfds, evb_t ev, CLOSURE);
   size_t id () const { return _id; }
   void lazy_startup (evb_t ev, CLOSURE);
   void set_state (okc_state_t s) { _state = s; }
@@ -413,7 +417,8 @@ public:
   //bool parse_service_options (vec<str> *v, ok_usr_t **u, const str &loc);
 
   void gather_helper_fds (str s, int *log, int *pub, evb_t ev, CLOSURE);
-  ptr<axprt_unix> spawn_proc (okld_ch_t *ch, int lfd, int pfd);
+  ptr<axprt_unix> spawn_proc (okld_ch_t *ch, int lfd, int pfd, 
+			      vec<int> *wfds);
   void launch (evv_t ev, CLOSURE);
   bool can_exec ();
   void assign_uid (int u);
@@ -504,7 +509,8 @@ public:
   void launch_logd (evi_t ev, CLOSURE);
   void launch_pubd (evi_t ev, CLOSURE);
 
-  bool launch_okd (int logfd, int pubd);
+  bool launch_okd (size_t wid, int logfd, int pubd);
+  void launch_okd_workers (evb_t ev, CLOSURE);
   void launch_okssl (evb_t ev, CLOSURE);
 
   bool parseconfig (const str &cf);
@@ -516,7 +522,9 @@ public:
   void set_signals ();
   void caught_signal (int sig);
   void caught_okd_eof ();
+  void okd_worker_died (size_t wid, int status);
   void okd_dispatch (svccb *sbp);
+  void collect_worker_stats (svccb *sbp, CLOSURE);
   void shutdown1 ();
   void shutdown2 (int status);
   void shutdown_ssl (int status);
@@ -546,6 +554,11 @@ public:
 
   okld_helper_t &okd () { return _okd; }
   const okld_helper_t &okd () const { return _okd; }
+
+  // okd accept workers; worker 0 is the primary okd above.
+  size_t n_okd_workers () const { return _okd_workers.size () + 1; }
+  okld_helper_t &okd_worker (size_t i) 
+  { return i ? *_okd_workers[i - 1] : _okd; }
   const ok_grp_t &coredump_grp () const { return _coredump_grp; }
   const ok_usr_t &coredump_usr () const { return _coredump_usr; }
   int coredump_mode () const { return _coredump_mode; }
@@ -632,6 +645,7 @@ private:
 
 
   okld_helper_t _okd;
+  vec<ptr<okld_helper_t> > _okd_workers; // accept workers 1..N-1
   qhash<str, ptr<okld_helper_ssl_t> > _okssls;
   bool _auto_activate;
   vec<str> _ssl_exec_params;
@@ -0,0 +1,72 @@
+
+desc = "streamed output: chunked and gzipped framing of output_file_stream"
+
+n = 3000
+
+filedata = """
+{$
+   for (i, range (0, %(n)d)) {
+      print ("line ", i, "\\n");
+      if (i == 10) { flush (); }
+   }
+$}
+""" % { "n" : n }
+
+##-----------------------------------------------------------------------
+
+def _fetch (case):
+    import socket
+    import urlparse
+    import zlib
+
+    url = "%s/%s.html?stream=1" % (case.config ().scratch_url (), case.name ())
+    u = urlparse.urlparse (url)
+
+    s = socket.create_connection ((u.hostname, u.port))
+    s.sendall ("GET %s?%s HTTP/1.1\r\n"
+               "Host: %s\r\n"
+               "Accept-Encoding: gzip\r\n"
+               "Connection: close\r\n\r\n" % (u.path, u.query, u.hostname))
+    resp = ""
+    while True:
+        b = s.recv (65536)
+        if not b:
+            break
+        resp += b
+    s.close ()
+
+    (hdr, body) = resp.split ("\r\n\r\n", 1)
+    lhdr = hdr.lower ()
+    if lhdr.find ("transfer-encoding: chunked") < 0:
+        return "not chunked:\n" + hdr
+    if lhdr.find ("content-encoding: gzip") < 0:
+        return "not gzipped:\n" + hdr
+
+    # Take the body apart one chunk at a time; it has to end with the
+    # zero-length chunk, and nothing after it.
+    data = ""
+    nchunks = 0
+    while True:
+        (szline, body) = body.split ("\r\n", 1)
+        sz = int (szline, 16)
+        if sz == 0:
+            if body != "\r\n":
+                return "junk after last chunk: %r" % body
+            break
+        if body[sz:sz+2] != "\r\n":
+            return "chunk %d not followed by CRLF" % nchunks
+        data += body[:sz]
+        body = body[sz+2:]
+        nchunks += 1
+
+    if nchunks < 3:
+        return "only %d chunks; expected output to be streamed" % nchunks
+
+    # One gzip member across all of the chunks.
+    return zlib.decompress (data, 16 + zlib.MAX_WBITS)
+
+custom_fetch = _fetch
+
+##-----------------------------------------------------------------------
+
+outcome = '\n'.join ([ "line %d" % i for i in range (0, n) ])